@@ -0,0 +1,205 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace fesd
+{
+
+template <typename T>
+class AsyncResult;
+
+namespace detail
+{
+
+// State shared between an operation in flight and the handle to its result
+template <typename T>
+class AsyncState final
+{
+public:
+    template <typename... Args>
+    void setValue(Args&&... args)
+    {
+        complete([&]() { m_value.emplace(std::forward<Args>(args)...); });
+    }
+
+    void setException(std::exception_ptr error)
+    {
+        complete([&]() { m_error = error; });
+    }
+
+    bool ready(void)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        return m_done;
+    }
+
+    void wait(void)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this]() { return m_done; });
+    }
+
+    template <typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_ready.wait_for(lock, timeout, [this]() { return m_done; });
+    }
+
+    // Returns false when the result is already there and the coroutine can carry on without suspending
+    bool suspend(std::coroutine_handle<> continuation)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        if (m_done)
+            return false;
+        m_continuation = continuation;
+        return true;
+    }
+
+    T take(void)
+    {
+        wait();
+        if (m_error)
+            std::rethrow_exception(m_error);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*m_value);
+    }
+
+private:
+    template <typename Setter>
+    void complete(Setter&& setter)
+    {
+        std::coroutine_handle<> continuation;
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            setter();
+            m_done = true;
+            continuation = std::exchange(m_continuation, nullptr);
+        }
+        m_ready.notify_all();
+
+        // An awaiting coroutine carries on in the thread that completed the operation
+        if (continuation)
+            continuation.resume();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    bool m_done = false;
+    std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> m_value;
+    std::exception_ptr m_error;
+    std::coroutine_handle<> m_continuation;
+};
+
+template <typename T>
+struct AsyncPromiseBase
+{
+    std::shared_ptr<AsyncState<T>> state = std::make_shared<AsyncState<T>>();
+
+    AsyncResult<T> get_return_object(void)
+    {
+        return AsyncResult<T>(state);
+    }
+
+    // Coroutines start straight away and clean up after themselves, the result lives on in the shared state
+    std::suspend_never initial_suspend(void) noexcept { return {}; }
+    std::suspend_never final_suspend(void) noexcept { return {}; }
+
+    void unhandled_exception(void)
+    {
+        state->setException(std::current_exception());
+    }
+};
+
+template <typename T>
+struct AsyncPromise : AsyncPromiseBase<T>
+{
+    void return_value(T value)
+    {
+        this->state->setValue(std::move(value));
+    }
+};
+
+template <>
+struct AsyncPromise<void> : AsyncPromiseBase<void>
+{
+    void return_void(void)
+    {
+        state->setValue();
+    }
+};
+
+} // namespace detail
+
+// Result of an asynchronous operation. Like std::future it can be waited on and read once with get(),
+// it can also be co_awaited and used as the return type of a coroutine.
+// A coroutine awaiting a result is resumed on the driver I/O thread that completed it, blocking driver calls
+// are not allowed there.
+template <typename T>
+class AsyncResult final
+{
+public:
+    using promise_type = detail::AsyncPromise<T>;
+
+    explicit AsyncResult(std::shared_ptr<detail::AsyncState<T>> state) : m_state(std::move(state)) {}
+    AsyncResult(AsyncResult&&) = default;
+    AsyncResult& operator=(AsyncResult&&) = default;
+    AsyncResult(const AsyncResult&) = delete;
+    AsyncResult& operator=(const AsyncResult&) = delete;
+
+    bool ready(void) const { return m_state->ready(); }
+    void wait(void) const { m_state->wait(); }
+
+    // Returns false if the operation has not completed within the timeout
+    template <typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const
+    {
+        return m_state->waitFor(timeout);
+    }
+
+    // Blocks until the operation completes, then returns its value or throws its error
+    T get(void) { return m_state->take(); }
+
+    bool await_ready(void) const { return m_state->ready(); }
+    bool await_suspend(std::coroutine_handle<> continuation) { return m_state->suspend(continuation); }
+    T await_resume(void) { return m_state->take(); }
+
+private:
+    std::shared_ptr<detail::AsyncState<T>> m_state;
+};
+
+// Producer side of an AsyncResult, completes it from a callback
+template <typename T>
+class AsyncCompletion final
+{
+public:
+    AsyncCompletion() : m_state(std::make_shared<detail::AsyncState<T>>()) {}
+
+    AsyncResult<T> result(void) const { return AsyncResult<T>(m_state); }
+
+    template <typename... Args>
+    void setValue(Args&&... args) const
+    {
+        m_state->setValue(std::forward<Args>(args)...);
+    }
+
+    void setException(std::exception_ptr error) const
+    {
+        m_state->setException(error);
+    }
+
+private:
+    std::shared_ptr<detail::AsyncState<T>> m_state;
+};
+
+} // namespace fesd
@@ -2,6 +2,7 @@
 
 #include <fesd/types/Common.hpp>
 #include <fesd/config.h>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -24,7 +25,12 @@ public:
 public:
     DeviceType getDeviceType(void) const;
     uint16_t getSlotId(void) const;
-    void resetDevice(void) const;
+    // Returns once the device answers again, with the time it took to be ready after the reset
+    std::chrono::milliseconds resetDevice(void) const;
+    // Calls queued or in flight on the port fail with a CancellationError, including those for the other devices on it
+    void cancelPending(void) const;
+    // Time the last (re)open of the device's port took until the device was ready
+    std::chrono::microseconds getPortOpenLatency(void) const;
     std::string getSerialNumber(void) const;
     std::string getFirmwareVersion(void) const;
     SystemRole getSystemRole(void) const;
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <fesd/config.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace fesd
+{
+
+// Lets a caller abandon driver calls, copies share the same state.
+// Once cancelled, calls made under the token that are still queued fail and the one in flight on a port is abandoned,
+// all with a CancellationError. The token stays cancelled, a new one is needed for the next calls.
+class FESD_API CancellationToken final
+{
+public:
+    CancellationToken();
+
+    // Thread safe, returns without waiting for the calls to complete
+    void cancel(void) const;
+    bool cancelled(void) const;
+    // Throws CancellationError once cancelled
+    void throwIfCancelled(void) const;
+
+    // Called once on cancel(), straight away if the token is already cancelled. A listener replaces the one with the same key.
+    // Listeners run on the cancelling thread and must not block.
+    void subscribe(const void* key, std::function<void(void)> listener) const;
+    void unsubscribe(const void* key) const;
+
+private:
+    struct State;
+#pragma warning(push)
+#pragma warning(disable:4251)
+    std::shared_ptr<State> m_state;
+#pragma warning(pop)
+};
+
+// Makes every driver call of this thread cancellable by the token while the scope is alive.
+// A nested scope's token is also cancelled with the outer one. Asynchronous operations keep the token when they are started.
+// Must not be held across a co_await, the coroutine may be resumed on another thread.
+class FESD_API CancellationScope final
+{
+public:
+    explicit CancellationScope(CancellationToken token);
+    ~CancellationScope();
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+
+    // Token in force on this thread, none outside of a scope
+    static std::optional<CancellationToken> current(void);
+
+private:
+#pragma warning(push)
+#pragma warning(disable:4251)
+    std::optional<CancellationToken> m_previous;
+    CancellationToken m_token;
+#pragma warning(pop)
+};
+
+} // namespace fesd
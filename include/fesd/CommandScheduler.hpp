@@ -0,0 +1,52 @@
+#pragma once
+
+#include <fesd/config.h>
+#include <fesd/types/Common.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fesd
+{
+
+class DeviceConnection;
+class SC2470Processor;
+
+// Sends commands at given times from a dedicated thread, for TDD and hopping schedules. The thread sleeps until shortly
+// before a command is due and spins for the rest, the command then goes to its port without readback.
+// Commands are added by the device commanders, for example SC2470Commander::scheduleFrequencies.
+// A command waits for the one in progress on its port, keep other traffic off the port around due times.
+class FESD_API CommandScheduler final
+{
+public:
+    // Throws InvalidArgumentsError if pinning or priority could not be applied
+    explicit CommandScheduler(const SchedulerSettings& settings = {});
+    // Drops the commands not sent yet, the ones in progress complete on their own
+    ~CommandScheduler();
+    CommandScheduler(const CommandScheduler&) = delete;
+    CommandScheduler& operator=(const CommandScheduler&) = delete;
+
+    // Drops the commands not sent yet and returns how many there were
+    std::size_t cancelPending(void);
+    // Waits until every command scheduled so far has been sent and completed
+    void waitIdle(void) const;
+    ScheduleStats getStats(void) const;
+    void resetStats(void);
+
+private:
+    friend class SC2470Processor;
+    // Commands due at the same time go out in the order they were added
+    void add(std::chrono::steady_clock::time_point due, std::shared_ptr<DeviceConnection> connection, std::vector<std::string> messages);
+
+private:
+    struct Detail;
+#pragma warning(push)
+#pragma warning(disable:4251)
+    std::shared_ptr<Detail> m_detail;
+#pragma warning(pop)
+};
+
+} // namespace fesd
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <fesd/config.h>
+
+#include <chrono>
+#include <optional>
+
+namespace fesd
+{
+
+// Point in time by which an operation has to complete, none when unbounded
+using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+// Bounds every driver call made by this thread while the scope is alive, a multi-command operation as a whole.
+// Nested scopes can only bring the deadline forward. Asynchronous operations keep the deadline in force when they are started.
+// Must not be held across a co_await, the coroutine may be resumed on another thread.
+class FESD_API DeadlineScope final
+{
+public:
+    explicit DeadlineScope(std::chrono::steady_clock::time_point deadline);
+    explicit DeadlineScope(std::chrono::steady_clock::duration budget);
+    ~DeadlineScope();
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+    // Earliest of the deadline in force on this thread and the one given
+    static Deadline current(Deadline deadline = std::nullopt);
+
+private:
+    Deadline m_previous;
+};
+
+} // namespace fesd
@@ -35,12 +35,23 @@ public:
     [[nodiscard]] SC2470Commander getSC2470Commander(const uint16_t slotId) const;
     [[nodiscard]] SC2470Commander getSC2470Commander(const FEDevice& device) const;
     [[nodiscard]] std::vector<SC2470Commander> getSC2470Commanders(void) const;
+    // Number of commands written ahead of their responses by multi-command operations, minimum of 1
+    void setPipelineDepth(uint16_t depth) const;
+    // Time devices are given to answer each class of command
+    void setCommandTimeouts(const CommandTimeouts& timeouts) const;
+    // Reopens ports that fail, checks that they lead to the same devices and restores the settings made through the driver
+    void setAutoRecovery(const RecoverySettings& settings) const;
+    // Keeps the last known settings of each device, devices found later included, and answers queries from them
+    void setShadowState(bool enable);
+    // Process wide, applies to the I/O threads of every driver instance
+    static void configureIoThreads(const IoThreadSettings& settings);
 
 private:
 #pragma warning(push) 
 #pragma warning(disable:4251)
     DeviceMap m_deviceMap;
 #pragma warning(pop)  
+    bool m_shadowState = false;
 };
 
 } // namespace fesd
\ No newline at end of file
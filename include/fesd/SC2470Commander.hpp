@@ -1,24 +1,64 @@
 #pragma once
 
 #include <fesd/config.h>
+#include <fesd/Async.hpp>
+#include <fesd/Deadline.hpp>
 #include <fesd/types/SC2470.hpp>
 #include <fesd/BaseCommander.hpp>
+#include <fesd/CommandScheduler.hpp>
+#include <fesd/SC2470PreparedSetting.hpp>
+#include <fesd/SC2470Sweep.hpp>
 
 #include <string>
+#include <chrono>
 #include <cstdint>
 #include <map>
+#include <span>
 
 namespace fesd
 {
 
 class FESD_API SC2470Processor;
 class DeviceConnection;
+class ReadbackVerifier;
 
 class FESD_API SC2470Commander final : public BaseCommander
 {
 public:
     SC2470Commander(std::shared_ptr<DeviceDetails> device);
 
+    // Applies to the synchronous configure calls of this commander, Always by default.
+    // A deferred readback that does not match is thrown as a CommunicationError by the next configure call or verifyReadbacks().
+    void setReadbackPolicy(SC2470::ReadbackPolicy policy);
+    SC2470::ReadbackPolicy getReadbackPolicy(void) const;
+    // Waits for the deferred readbacks in flight
+    void verifyReadbacks(void) const;
+
+    // Applies a channel setup with the settings that differ from the current ones, read from the shadow state when there is one.
+    // Retunes are sent first and everything is pipelined, then read back at once. Returns the settings given as the device reports them,
+    // or as sent under the Never and Deferred readback policies.
+    SC2470::Configuration configure(const SC2470::Configuration& config) const;
+    // Staged update, the settings are held on the host by this commander, the device has no command to hold them. applyStaged() sends them
+    // as one pipelined batch as configure() does, each taking effect as the device receives it, then waits once for the reference PLL to lock.
+    // The batch ends with a CONFIG:APPLY, which makes the device relock once more, so the wait lasts longer than configure() and waitForLock().
+    // A setting staged again replaces the one before. With nothing staged, applyStaged() sends nothing and returns an empty configuration.
+    // The staged settings are cleared once applied. If applyStaged() throws, they are kept for a retry or discardStaged(),
+    // while the device may have taken some of them, as after a failed configure().
+    void stage(const SC2470::Configuration& config);
+    SC2470::Configuration applyStaged(void);
+    void discardStaged(void);
+    const SC2470::Configuration& getStaged(void) const;
+    // Validates and encodes frequency hops for this device, an invalid hop throws an InvalidArgumentsError naming it
+    SC2470Sweep compileSweep(std::span<const SC2470::Hop> hops) const;
+    // Gain and phase increment encoded once for stepping loops, sent as given without clamping or readback.
+    // A phase increment only applies in forced fractional mode, which configurePhaseOffset sets.
+    SC2470PreparedSetting prepareGain(SC2470::Path path) const;
+    SC2470PreparedSetting preparePhaseIncrement(SC2470::Path path) const;
+    // Settings sent by the scheduler at the given time, encoded now and sent as given without clamping or readback.
+    // Failures are only counted in the scheduler's statistics, invalid frequencies throw an InvalidArgumentsError here.
+    void scheduleFrequencies(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, SC2470::Path path, SC2470::FrequencySet freqs) const;
+    void scheduleGain(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, SC2470::Path path, double gainDb) const;
+    void scheduleDuplexSetting(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, SC2470::DuplexSetting setting) const;
     double configureGain(SC2470::Path path, double gainDb) const;
     double configureAttenuation(SC2470::Path path, double attenuationDb) const;
     SC2470::FrequencySet configureFrequencies(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::IfFrequency ifFreq) const;
@@ -30,7 +70,10 @@ public:
     bool configureLoEnable(SC2470::Path path, bool enable) const;
     double configureLoFrequency(SC2470::Path path, double frequencyHz) const; 
     SC2470::DuplexSetting configureDuplexSetting(SC2470::DuplexSetting setting) const;    
+    // The LOs are re-applied behind the reference change, then the reference PLL is polled until it locks.
+    // A reference that does not lock within the retune timeout throws a CommunicationError.
     SC2470::ReferenceSource configureReferenceSource(SC2470::ReferenceSource source) const;
+    SC2470::ReferenceSwitch switchReferenceSource(SC2470::ReferenceSource source) const;
     SC2470::InternalReferenceFrequency configureInternalReferenceOverride(SC2470::Path path, SC2470::InternalReferenceFrequency freq) const;
     double configurePhaseOffset(SC2470::Path path, double offset) const;
     SC2470::DCBias configureDCBias(SC2470::Path path, SC2470::DCBias bias) const;
@@ -50,12 +93,45 @@ public:
     double getPhaseOffset(SC2470::Path path) const;  
     SC2470::DCBias getDCBias(SC2470::Path path) const;
     bool getReferenceOutputEnable(void) const;
+    // Telemetry, polls wait for the configuration calls queued on the same port
+    double getPaTemperature(void) const;
+    double getReferenceLockDetect(void) const;
+    // Polls the lock detect until the device has locked, with an interval that backs off from a fraction of its median settle time.
+    // The SC2470 reports one lock detect for its reference and synthesizers. Returns the time from the call to the lock,
+    // a CommunicationError past the timeout.
+    std::chrono::nanoseconds waitForLock(std::chrono::milliseconds timeout) const;
+    // Waits for the Deferred readbacks started so far, reporting a mismatch as verifyReadbacks() does, then for the lock
+    // within the retune timeout. Returns the time from the call to the lock.
+    std::chrono::nanoseconds waitForSettled(void) const;
+    // Lock waits of this device by any of its commanders, including reference switches and applyStaged()
+    SettleStats getSettleStats(void) const;
+    void resetSettleStats(void) const;
+
+    // Asynchronous variants, the results can be waited on from any thread or co_awaited.
+    // Set operations are pipelined with their readback whatever the readback policy. The deadline of the calling thread's DeadlineScope applies.
+    AsyncResult<double> configureGainAsync(SC2470::Path path, double gainDb) const;
+    AsyncResult<double> configureAttenuationAsync(SC2470::Path path, double attenuationDb) const;
+    AsyncResult<SC2470::FrequencySet> configureFrequenciesAsync(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::IfFrequency ifFreq) const;
+    AsyncResult<SC2470::FrequencySet> configureFrequenciesAsync(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::LoFrequency loFreq) const;
+    AsyncResult<SC2470::FrequencySet> configureFrequenciesAsync(SC2470::Path path, SC2470::IfFrequency ifFreq, SC2470::LoFrequency loFreq) const;
+    AsyncResult<SC2470::FrequencySet> configureFrequenciesAsync(SC2470::Path path, SC2470::FrequencySet freqs) const;
+    AsyncResult<SC2470::FrequencySet> configureBypassFrequencyAsync(SC2470::Path path, SC2470::BypassFrequency byFreq) const;
+    AsyncResult<double> configureLoFrequencyAsync(SC2470::Path path, double frequencyHz) const;
+
+    AsyncResult<SC2470::GainLimitsSet> getGainLimitsAsync(SC2470::Path path) const;
+    AsyncResult<double> getGainAsync(SC2470::Path path) const;
+    AsyncResult<double> getAttenuationAsync(SC2470::Path path) const;
+    AsyncResult<SC2470::FrequencySet> getFrequenciesAsync(SC2470::Path path) const;
+    AsyncResult<double> getLoFrequencyAsync(SC2470::Path path) const;
     
 private:
 #pragma warning(push) 
 #pragma warning(disable:4251)
     std::shared_ptr<SC2470Processor> m_coProcessor;
+    std::shared_ptr<ReadbackVerifier> m_readbacks;
 #pragma warning(pop) 
+    SC2470::ReadbackPolicy m_readbackPolicy = SC2470::ReadbackPolicy::Always;
+    SC2470::Configuration m_staged;
     bool useAttn = false;
 };
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <fesd/config.h>
+
+#include <memory>
+
+namespace fesd
+{
+
+class PreparedCommand;
+
+// Setting of one device path encoded once by SC2470Commander, for loops that step it at the link's full rate.
+// Each set only formats the value into a message allocated up front and sends it, without clamping or readback.
+// The message is owned by one setting, so it can be moved but not copied, and is not to be used by several threads at once.
+class FESD_API SC2470PreparedSetting final
+{
+public:
+    SC2470PreparedSetting(SC2470PreparedSetting&&) = default;
+    SC2470PreparedSetting& operator=(SC2470PreparedSetting&&) = default;
+    SC2470PreparedSetting(const SC2470PreparedSetting&) = delete;
+    SC2470PreparedSetting& operator=(const SC2470PreparedSetting&) = delete;
+
+    void set(double value);
+
+private:
+    friend class SC2470Commander;
+    explicit SC2470PreparedSetting(std::shared_ptr<PreparedCommand> command);
+
+private:
+#pragma warning(push)
+#pragma warning(disable:4251)
+    std::shared_ptr<PreparedCommand> m_command;
+#pragma warning(pop)
+};
+
+} // namespace fesd
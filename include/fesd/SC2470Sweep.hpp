@@ -0,0 +1,54 @@
+#pragma once
+
+#include <fesd/config.h>
+#include <fesd/types/SC2470.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fesd
+{
+
+class SC2470Commander;
+class SC2470Processor;
+
+// Frequency hops compiled by SC2470Commander::compileSweep, validated and encoded once and then streamed as fast as the link allows.
+// Without a hop callback, hops that have no dwell are queued ahead on the port so the device takes each one as soon as it is free.
+class FESD_API SC2470Sweep final
+{
+public:
+    // Runs on the thread of run() once the device has acknowledged a hop, before its dwell. Throwing stops the sweep.
+    using HopCallback = std::function<void(std::size_t index, const SC2470::Hop& hop)>;
+
+    // One hop per line: path (RX or TX), RF, IF and LO in Hz, dwell in us. Blank lines and lines starting with # are skipped.
+    static std::vector<SC2470::Hop> readCsv(const std::string& path);
+    // "FESDHOPS", uint32 version, uint32 number of hops, then per hop: uint8 path (0 RX, 1 TX), 3 reserved bytes,
+    // uint32 dwell in us, double RF, IF and LO in Hz. In host byte order.
+    static std::vector<SC2470::Hop> readBinary(const std::string& path);
+    static void writeBinary(const std::string& path, std::span<const SC2470::Hop> hops);
+
+    void setHopCallback(HopCallback callback);
+    std::size_t size(void) const;
+    // Sends the hops in order and holds the last one for its dwell. A hop the device fails throws a CommunicationError
+    // once the ones in flight are done. The deadline of the calling thread's DeadlineScope bounds the whole sweep.
+    SC2470::SweepReport run(void) const;
+
+private:
+    friend class SC2470Commander;
+    SC2470Sweep(std::shared_ptr<SC2470Processor> processor, std::vector<SC2470::Hop> hops, std::vector<std::string> messages);
+
+private:
+#pragma warning(push)
+#pragma warning(disable:4251)
+    std::shared_ptr<SC2470Processor> m_processor;
+    std::vector<SC2470::Hop> m_hops;
+    std::vector<std::string> m_messages; // Frequency command of each hop
+    HopCallback m_callback;
+#pragma warning(pop)
+};
+
+} // namespace fesd
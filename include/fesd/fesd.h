@@ -15,7 +15,8 @@ extern "C" {
         FESD_CODES_SUCCESS      = 0,
         FESD_CODES_INVALID_ARGS = -1,
         FESD_CODES_COMMS_ERR    = -2,
-        FESD_CODES_CALIBRATION_ERR = -3
+        FESD_CODES_CALIBRATION_ERR = -3,
+        FESD_CODES_CANCELLED    = -4
     } FESD_Codes_t;
 
     typedef enum
@@ -63,6 +64,13 @@ extern "C" {
         FESD_SC2470_SYNTH_MODE_FRACTIONAL   = 1,
     } FESD_SC2470SynthesizerMode_t;
 
+    typedef enum
+    {
+        FESD_SC2470_READBACK_ALWAYS     = 0,
+        FESD_SC2470_READBACK_NEVER      = 1,
+        FESD_SC2470_READBACK_DEFERRED   = 2,
+    } FESD_SC2470ReadbackPolicy_t;
+
     typedef void* SessionRef_t;
     typedef void* DeviceRef_t;
 
@@ -74,13 +82,24 @@ extern "C" {
     FESD_API int16_t FESD_GetDevices(SessionRef_t session, uint16_t size, uint16_t* slotIDs, FESD_DeviceType_t* types, uint32_t* serialNumbers, double* firmwareVersions, double* hardwareVersions);
     FESD_API int16_t FESD_SendDirectCommand(SessionRef_t session, char* command, char* result, uint16_t* size);
     FESD_API int16_t FESD_InitializeSC2470Commander(SessionRef_t session, uint32_t serialNumber, DeviceRef_t* sc2470Ref);
+    FESD_API int16_t FESD_SetPipelineDepth(SessionRef_t session, uint16_t depth);
+    FESD_API int16_t FESD_SetCommandTimeouts(SessionRef_t session, uint32_t fastMs, uint32_t retuneMs, uint32_t nvmMs, uint32_t rebootMs);
+    FESD_API int16_t FESD_SetAutoRecovery(SessionRef_t session, bool enable, uint32_t timeoutMs);
+    FESD_API int16_t FESD_SetShadowState(SessionRef_t session, bool enable);
+    FESD_API int16_t FESD_ConfigureIoThreads(uint16_t threads, const int16_t* cpus, uint16_t cpuCount, int16_t realtimePriority);
 
     FESD_API int16_t FESD_GetId(DeviceRef_t device, uint16_t* id);
     FESD_API int16_t FESD_ResetDevice(DeviceRef_t device);
+    FESD_API int16_t FESD_ResetDeviceTimed(DeviceRef_t device, uint32_t* readyMs);
+    FESD_API int16_t FESD_CancelPending(DeviceRef_t device);
+    FESD_API int16_t FESD_GetPortOpenLatency(DeviceRef_t device, uint32_t* latencyUs);
     FESD_API int16_t FESD_GetSerialNumber(DeviceRef_t device, char* serialNumber, uint16_t* size);
     FESD_API int16_t FESD_GetFirmwareVersion(DeviceRef_t device, char* firmwareVersion, uint16_t* size);
     FESD_API int16_t FESD_GetSystemRole(DeviceRef_t device, FESD_SystemRole_t* systemRole);
 
+    FESD_API int16_t FESD_SC2470SetReadbackPolicy(DeviceRef_t device, FESD_SC2470ReadbackPolicy_t policy);
+    FESD_API int16_t FESD_SC2470VerifyReadbacks(DeviceRef_t device);
+
     FESD_API int16_t FESD_SC2470ConfigureGain(DeviceRef_t device, FESD_Path_t path, double* gain);
     FESD_API int16_t FESD_SC2470ConfigureAttenuation(DeviceRef_t device, FESD_Path_t path, double* attn);
     FESD_API int16_t FESD_SC2470ConfigureFrequenciesRfIf(DeviceRef_t device, FESD_Path_t path, double* rfHz, double* ifHz);
@@ -112,6 +131,8 @@ extern "C" {
     FESD_API int16_t FESD_SC2470GetDCBias(DeviceRef_t device, FESD_Path_t path, int16_t* iBias,  int16_t* qBias);
     FESD_API int16_t FESD_SC2470GetReferenceOutputEnable(DeviceRef_t device, bool* enable);
     FESD_API int16_t FESD_SC2470GetLoEnable(DeviceRef_t device, FESD_Path_t path, bool* enable);
+    FESD_API int16_t FESD_SC2470GetPaTemperature(DeviceRef_t device, double* temperature);
+    FESD_API int16_t FESD_SC2470GetReferenceLockDetect(DeviceRef_t device, double* lockDetect);
 
     
 #ifdef __cplusplus
@@ -2,6 +2,12 @@
 
 #include <fesd/config.h>
 #include <fesd/version.hpp>
+#include <fesd/Async.hpp>
+#include <fesd/Cancellation.hpp>
+#include <fesd/CommandScheduler.hpp>
+#include <fesd/Deadline.hpp>
 #include <fesd/FESerialDriver.hpp>
 #include <fesd/SC2470Commander.hpp>
+#include <fesd/SC2470PreparedSetting.hpp>
+#include <fesd/SC2470Sweep.hpp>
 #include <fesd/types/Exception.hpp>
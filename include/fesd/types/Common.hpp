@@ -1,5 +1,10 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace fesd {
 
 enum class SystemRole
@@ -13,4 +18,66 @@ enum class DeviceType
    Undefined,
    SC2470,
 };
+
+// Threads that perform the I/O of every port in the process
+struct IoThreadSettings
+{
+   uint16_t threads = 1;        // Ports are spread over the threads, the number of threads can only grow
+   std::vector<int> cpus;       // Thread n is pinned to cpus[n % size], empty for no pinning
+   int realtimePriority = 0;    // Real-time (SCHED_FIFO / time critical) priority when above 0, may need elevated privileges
+};
+
+// Thread that sends the commands of a CommandScheduler
+struct SchedulerSettings
+{
+   int cpu = -1;                             // CPU the thread is pinned to, -1 for no pinning
+   int realtimePriority = 0;                 // Real-time (SCHED_FIFO / time critical) priority when above 0, may need elevated privileges
+   std::chrono::microseconds spin{200};      // The thread sleeps until this long before a command is due, then spins
+   std::chrono::nanoseconds binWidth{10000}; // Resolution of the timing histograms
+   std::size_t bins = 100;                   // The last bin also counts the times beyond it
+};
+
+struct TimingHistogram
+{
+   std::chrono::nanoseconds binWidth{0};
+   std::vector<uint64_t> counts;
+   uint64_t samples = 0;
+   std::chrono::nanoseconds min{0};
+   std::chrono::nanoseconds max{0};
+   std::chrono::nanoseconds mean{0};
+};
+
+struct ScheduleStats
+{
+   uint64_t sent = 0;                  // Commands the device acknowledged
+   uint64_t failed = 0;                // Commands that failed or that the device rejected
+   TimingHistogram dispatchJitter;     // From the time a command was due to its first byte being written to the port
+   TimingHistogram completionLatency;  // From the write to the device's acknowledgement
+};
+
+// Lock waits of a device, for sizing dwell times
+struct SettleStats
+{
+   uint64_t timeouts = 0;              // Waits that ran out before the device locked
+   TimingHistogram settleTime;         // From the start of a wait to the lock being seen
+   std::chrono::nanoseconds p50{0};    // Upper edges of the histogram bins, at most the longest settle time
+   std::chrono::nanoseconds p90{0};
+   std::chrono::nanoseconds p99{0};
+};
+
+// Time a device is given to answer a command, by kind of command
+struct CommandTimeouts
+{
+   std::chrono::milliseconds fast{1000};    // Queries and settings that take effect immediately
+   std::chrono::milliseconds retune{3000};  // Frequency, reference and synthesizer changes that relock the PLLs
+   std::chrono::milliseconds nvm{10000};    // CONFIG:SAVE, CONFIG:LOAD and CONFIG:DEFAULT
+   std::chrono::milliseconds reboot{30000}; // Upper bound for a device to be ready again after a reset
+};
+
+// Reopening a port that failed, for example a USB serial adapter that re-enumerated
+struct RecoverySettings
+{
+   bool enabled = false;
+   std::chrono::milliseconds timeout{30000}; // Calls wait this long for the port to come back, then fail until it does
+};
 }
\ No newline at end of file
@@ -10,6 +10,12 @@ public:
     CommunicationError(const std::string& what) : std::runtime_error(what) {}
 };
 
+class CancellationError : public CommunicationError
+{
+public:
+    CancellationError(const std::string& what) : CommunicationError(what) {}
+};
+
 class InvalidArgumentsError : public std::runtime_error
 {
 public:
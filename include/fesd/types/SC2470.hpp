@@ -1,6 +1,9 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 
 namespace fesd 
 {
@@ -41,6 +44,15 @@ enum class Path
     TX,
 };
 
+// How the configure calls confirm a setting. Always reads it back and returns what the device reports,
+// Never returns the value the driver sent, Deferred returns that too and reads it back in the background.
+enum class ReadbackPolicy
+{
+    Always,
+    Never,
+    Deferred,
+};
+
 struct SynthesizerSettings
 {
     static constexpr uint16_t powerMax = 15;
@@ -208,6 +220,58 @@ struct DCBias
 
 };
 
+// Settings of one path for SC2470Commander::configure, the ones left empty are not changed
+struct PathConfiguration
+{
+    std::optional<FrequencySet> frequencies; // As for configureFrequencies, the one given as 0 is derived from the other two
+    std::optional<double> gainDb;
+    std::optional<double> attenuationDb;
+    std::optional<SynthesizerSettings> synthesizer;
+    std::optional<bool> loEnable;
+    std::optional<InternalReferenceFrequency> internalReference;
+    std::optional<double> phaseOffset;
+    std::optional<DCBias> dcBias;
+};
+
+// Channel setup applied by SC2470Commander::configure in one go, the settings left empty are not changed
+struct Configuration
+{
+    std::optional<ReferenceSource> referenceSource;
+    std::optional<bool> referenceOutputEnable;
+    std::optional<DuplexSetting> duplex;
+    PathConfiguration rx;
+    PathConfiguration tx;
+
+    PathConfiguration& path(Path path) { return (path == Path::RX) ? rx : tx; }
+    const PathConfiguration& path(Path path) const { return (path == Path::RX) ? rx : tx; }
+};
+
+// Step of a frequency sweep, held for the dwell time once the device has acknowledged it
+struct Hop
+{
+    Path path;
+    FrequencySet frequencies; // As for configureFrequencies, the one given as 0 is derived from the other two
+    std::chrono::microseconds dwell;
+};
+
+struct ReferenceSwitch
+{
+    ReferenceSource source;
+    std::chrono::nanoseconds timeToLock; // From sending the change to the reference PLL reporting lock
+};
+
+struct SweepReport
+{
+    std::size_t hops;
+    std::chrono::nanoseconds elapsed;
+    double hopsPerSecond;
+    // Per hop, from the device being free to take the command to its acknowledgement
+    std::chrono::nanoseconds latencyP50;
+    std::chrono::nanoseconds latencyP90;
+    std::chrono::nanoseconds latencyP99;
+    std::chrono::nanoseconds latencyMax;
+};
+
 } // namespace SC2470
 
 } // namespace fesd
\ No newline at end of file
@@ -33,11 +33,21 @@ uint16_t BaseCommander::getSlotId(void) const
     return m_genProcessor->getDeviceDetails()->slotId;
 }
 
-void BaseCommander::resetDevice(void) const
+std::chrono::milliseconds BaseCommander::resetDevice(void) const
 {
     return m_genProcessor->resetDevice();
 }
 
+void BaseCommander::cancelPending(void) const
+{
+    m_genProcessor->getDeviceDetails()->connection->cancelPending();
+}
+
+std::chrono::microseconds BaseCommander::getPortOpenLatency(void) const
+{
+    return m_genProcessor->getDeviceDetails()->connection->getOpenLatency();
+}
+
 std::string BaseCommander::getSerialNumber(void) const
 {
     return m_genProcessor->getSerialNumber();
@@ -0,0 +1,100 @@
+#include <fesd/Cancellation.hpp>
+#include <fesd/types/Exception.hpp>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+thread_local std::optional<fesd::CancellationToken> threadToken;
+
+} // namespace
+
+namespace fesd {
+
+struct CancellationToken::State
+{
+    std::atomic<bool> cancelled = false;
+    std::mutex mutex;
+    std::map<const void*, std::function<void(void)>> listeners;
+};
+
+CancellationToken::CancellationToken()
+    : m_state(std::make_shared<State>())
+{
+}
+
+void CancellationToken::cancel(void) const
+{
+    std::map<const void*, std::function<void(void)>> listeners;
+    {
+        std::scoped_lock<std::mutex> lock(m_state->mutex);
+        if (m_state->cancelled.exchange(true))
+            return;
+        listeners = std::exchange(m_state->listeners, {});
+    }
+
+    for (const auto& [key, listener] : listeners)
+        listener();
+}
+
+bool CancellationToken::cancelled(void) const
+{
+    return m_state->cancelled;
+}
+
+void CancellationToken::throwIfCancelled(void) const
+{
+    if (cancelled())
+        throw CancellationError("Operation cancelled...");
+}
+
+void CancellationToken::subscribe(const void* key, std::function<void(void)> listener) const
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_state->mutex);
+        if (!m_state->cancelled)
+        {
+            m_state->listeners[key] = std::move(listener);
+            return;
+        }
+    }
+    listener();
+}
+
+void CancellationToken::unsubscribe(const void* key) const
+{
+    std::scoped_lock<std::mutex> lock(m_state->mutex);
+    m_state->listeners.erase(key);
+}
+
+CancellationScope::CancellationScope(CancellationToken token)
+    : m_previous(threadToken), m_token(std::move(token))
+{
+    if (m_previous)
+    {
+        m_previous->subscribe(this,
+            [token = m_token]()
+            {
+                token.cancel();
+            }
+        );
+    }
+    threadToken = m_token;
+}
+
+CancellationScope::~CancellationScope()
+{
+    if (m_previous)
+        m_previous->unsubscribe(this);
+    threadToken = m_previous;
+}
+
+std::optional<CancellationToken> CancellationScope::current(void)
+{
+    return threadToken;
+}
+
+} // namespace fesd
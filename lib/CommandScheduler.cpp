@@ -0,0 +1,212 @@
+#include <fesd/CommandScheduler.hpp>
+#include <fesd/Async.hpp>
+#include <fesd/types/Exception.hpp>
+#include "DeviceConnection.hpp"
+#include "TimingRecorder.hpp"
+#include "reactor/IoReactor.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Entry
+{
+    Clock::time_point due;
+    uint64_t sequence;
+    std::shared_ptr<fesd::DeviceConnection> connection;
+    std::vector<std::string> messages;
+};
+
+// Earliest due first, then in the order added
+struct Later
+{
+    bool operator()(const Entry& a, const Entry& b) const
+    {
+        return (a.due != b.due) ? a.due > b.due : a.sequence > b.sequence;
+    }
+};
+
+} // namespace
+
+namespace fesd {
+
+struct CommandScheduler::Detail : std::enable_shared_from_this<CommandScheduler::Detail>
+{
+    Detail(const SchedulerSettings& settings)
+        : spin(std::max(settings.spin, std::chrono::microseconds::zero())),
+        jitter(settings.binWidth, settings.bins),
+        latency(settings.binWidth, settings.bins)
+    {
+    }
+
+    const std::chrono::microseconds spin;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable idle;
+    std::priority_queue<Entry, std::vector<Entry>, Later> pending;
+    uint64_t sequence = 0;
+    std::size_t inFlight = 0;
+    bool stopping = false;
+
+    std::mutex statsMutex;
+    uint64_t sent = 0;
+    uint64_t failed = 0;
+    TimingRecorder jitter;
+    TimingRecorder latency;
+
+    std::thread thread;
+
+    void run(void);
+    void completed(void);
+    // The detail is kept alive until the command completes on its I/O thread
+    static AsyncResult<void> dispatch(std::shared_ptr<Detail> detail, Entry entry);
+};
+
+AsyncResult<void> CommandScheduler::Detail::dispatch(std::shared_ptr<Detail> detail, Entry entry)
+{
+    auto written = std::make_shared<std::optional<Clock::time_point>>();
+    bool success = false;
+    try
+    {
+        const TransactionResults results = co_await entry.connection->transactTimedAsync(std::move(entry.messages), [written](Clock::time_point time) { *written = time; });
+        success = written->has_value() && std::all_of(results.begin(), results.end(), [](const TransactionResult& result) { return result.success; });
+    }
+    catch (...)
+    {
+    }
+    // Resumed on the I/O thread that read the acknowledgement
+    const Clock::time_point done = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(detail->statsMutex);
+        if (success)
+        {
+            detail->sent++;
+            detail->jitter.add(written->value() - entry.due);
+            detail->latency.add(done - written->value());
+        }
+        else
+        {
+            detail->failed++;
+        }
+    }
+    detail->completed();
+}
+
+void CommandScheduler::Detail::run(void)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeup.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (stopping)
+            return;
+
+        // Sleeping is only accurate to the OS timer, the last stretch is spun. Yielding lets the I/O threads
+        // finish the previous command when they share the CPU.
+        const Clock::time_point due = pending.top().due;
+        if (wakeup.wait_until(lock, due - spin, [this, due]() { return stopping || pending.empty() || pending.top().due < due; }))
+            continue;
+        lock.unlock();
+        while (Clock::now() < due)
+            std::this_thread::yield();
+        lock.lock();
+
+        if (stopping)
+            return;
+        if (pending.empty() || pending.top().due > Clock::now())
+            continue;
+        Entry entry = pending.top();
+        pending.pop();
+        inFlight++;
+        lock.unlock();
+        dispatch(shared_from_this(), std::move(entry));
+        lock.lock();
+    }
+}
+
+void CommandScheduler::Detail::completed(void)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    inFlight--;
+    idle.notify_all();
+}
+
+CommandScheduler::CommandScheduler(const SchedulerSettings& settings)
+    : m_detail(std::make_shared<Detail>(settings))
+{
+    m_detail->thread = std::thread(&Detail::run, m_detail.get());
+    if (!applyThreadSettings(m_detail->thread, "fesd-sched", settings.cpu, settings.realtimePriority))
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_detail->mutex);
+            m_detail->stopping = true;
+        }
+        m_detail->wakeup.notify_all();
+        m_detail->thread.join();
+        throw InvalidArgumentsError("Could not apply scheduler thread CPU pinning or priority");
+    }
+}
+
+CommandScheduler::~CommandScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_detail->mutex);
+        m_detail->stopping = true;
+    }
+    m_detail->wakeup.notify_all();
+    m_detail->thread.join();
+}
+
+void CommandScheduler::add(Clock::time_point due, std::shared_ptr<DeviceConnection> connection, std::vector<std::string> messages)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_detail->mutex);
+        m_detail->pending.push({due, m_detail->sequence++, std::move(connection), std::move(messages)});
+    }
+    m_detail->wakeup.notify_all();
+}
+
+std::size_t CommandScheduler::cancelPending(void)
+{
+    std::size_t count;
+    {
+        std::lock_guard<std::mutex> lock(m_detail->mutex);
+        count = m_detail->pending.size();
+        m_detail->pending = {};
+    }
+    m_detail->wakeup.notify_all();
+    m_detail->idle.notify_all();
+    return count;
+}
+
+void CommandScheduler::waitIdle(void) const
+{
+    std::unique_lock<std::mutex> lock(m_detail->mutex);
+    m_detail->idle.wait(lock, [this]() { return m_detail->pending.empty() && m_detail->inFlight == 0; });
+}
+
+ScheduleStats CommandScheduler::getStats(void) const
+{
+    std::lock_guard<std::mutex> lock(m_detail->statsMutex);
+    return {m_detail->sent, m_detail->failed, m_detail->jitter.snapshot(), m_detail->latency.snapshot()};
+}
+
+void CommandScheduler::resetStats(void)
+{
+    std::lock_guard<std::mutex> lock(m_detail->statsMutex);
+    m_detail->sent = 0;
+    m_detail->failed = 0;
+    m_detail->jitter.reset();
+    m_detail->latency.reset();
+}
+
+} // namespace fesd
@@ -0,0 +1,182 @@
+#include "ConfigJournal.hpp"
+#include "Utility.hpp"
+
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <charconv>
+#include <set>
+#include <utility>
+
+namespace {
+
+// Settings that are replayed, with whether they are addressed by path
+const std::map<std::string_view, bool> ReplayedCommands = {
+    {"PATH:FREQ",       true },
+    {"PATH:GAIN",       true },
+    {"RFPATH:ATTN",     true },
+    {"IFPATH:ATTN",     true },
+    {"IFPATH:DCBIAS",   true },
+    {"LOCLK:FREQ",      true },
+    {"LOCLK:PHCUMU",    true },
+    {"SYN:FFRAC",       true },
+    {"RFPATH:PATH",     false},
+    {"RFPATH:TDD",      false},
+    {"REFPLL:CONFIG",   false},
+};
+
+// Commands that take the device back to its NVM or default configuration, the application builds on that again
+const std::set<std::string_view> RevertCommands = {
+    "*RST",
+    "CONFIG:LOAD",
+    "CONFIG:DEFAULT",
+};
+
+// Relative changes to a replayed setting, its absolute value has to be read back
+const std::map<std::string_view, std::string_view> RelativeCommands = {
+    {"LOCLK:PHINC", "LOCLK:PHCUMU"},
+};
+
+// Values are sent with six decimals, the device may answer with fewer
+const double ValueTolerance = 1.0E-9;
+
+std::vector<std::string> tokenize(std::string_view message)
+{
+    std::vector<std::string> tokens;
+    const std::string trimmed = boost::trim_copy(std::string(message));
+    if (!trimmed.empty())
+        boost::split(tokens, trimmed, boost::is_any_of(" "), boost::token_compress_on);
+    return tokens;
+}
+
+std::string_view mnemonicOf(std::string_view message)
+{
+    return message.substr(0, message.find(' '));
+}
+
+bool toNumber(const std::string& text, double& value)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+} // namespace
+
+namespace fesd {
+
+bool ConfigJournal::tracks(const std::vector<std::string>& messages)
+{
+    return std::any_of(messages.begin(), messages.end(),
+        [](const std::string& message)
+        {
+            const std::string_view mnemonic = mnemonicOf(message);
+            return ReplayedCommands.count(mnemonic) > 0 || RevertCommands.count(mnemonic) > 0 || RelativeCommands.count(mnemonic) > 0;
+        }
+    );
+}
+
+bool ConfigJournal::matches(const Entry& entry, std::string_view response)
+{
+    const std::vector<std::string> values = tokenize(response);
+    if (values.size() != entry.values.size())
+        return false;
+
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        double expected, actual;
+        if (toNumber(entry.values[i], expected) && toNumber(values[i], actual))
+        {
+            if (!utility::isAlmostEqual(expected, actual, ValueTolerance))
+                return false;
+        }
+        else if (!boost::iequals(entry.values[i], values[i]))
+            return false;
+    }
+    return true;
+}
+
+void ConfigJournal::record(const std::vector<std::string>& messages, const TransactionResults& results)
+{
+    for (std::size_t i = 0; i < messages.size() && i < results.size(); i++)
+    {
+        if (results[i].success)
+            record(messages[i]);
+    }
+}
+
+void ConfigJournal::record(const std::string& message)
+{
+    const std::vector<std::string> tokens = tokenize(message);
+    uint16_t slotId;
+    if (tokens.size() < 2)
+        return;
+    const auto [end, error] = std::from_chars(tokens[1].data(), tokens[1].data() + tokens[1].size(), slotId);
+    if (error != std::errc() || end != tokens[1].data() + tokens[1].size())
+        return;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    if (RevertCommands.count(tokens[0]) > 0)
+    {
+        std::erase_if(m_entries, [slotId](const auto& item) { return item.second.slotId == slotId; });
+        return;
+    }
+
+    const auto relative = RelativeCommands.find(tokens[0]);
+    if (relative != RelativeCommands.end() && tokens.size() > 2)
+    {
+        m_entries.erase(std::string(relative->second) + " " + tokens[1] + " " + tokens[2]);
+        m_stale.push_back(std::string(relative->second) + "? " + tokens[1] + " " + tokens[2] + " ");
+        return;
+    }
+
+    const auto replayed = ReplayedCommands.find(tokens[0]);
+    if (replayed == ReplayedCommands.end())
+        return;
+
+    // Mnemonic, slot and the path when the setting has one per path, the rest are the values
+    const std::size_t addressSize = replayed->second ? 3 : 2;
+    if (tokens.size() <= addressSize)
+        return;
+
+    Entry entry{slotId, ++m_sequence, message, tokens[0] + "?", {tokens.begin() + addressSize, tokens.end()}};
+    std::string key = tokens[0];
+    for (std::size_t i = 1; i < addressSize; i++)
+    {
+        key += " " + tokens[i];
+        entry.query += " " + tokens[i];
+    }
+    entry.query += " ";
+    m_entries[key] = std::move(entry);
+}
+
+std::vector<std::string> ConfigJournal::takeStale(void)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return std::exchange(m_stale, {});
+}
+
+void ConfigJournal::refresh(const std::string& query, std::string_view response)
+{
+    // The setting is made by the query's command with the values it answers
+    const std::size_t mark = query.find('?');
+    if (mark != std::string::npos)
+        record(query.substr(0, mark) + query.substr(mark + 1) + std::string(response) + " ");
+}
+
+std::vector<ConfigJournal::Entry> ConfigJournal::entries(uint16_t slotId) const
+{
+    std::vector<Entry> results;
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        for (const auto& [key, entry] : m_entries)
+        {
+            if (entry.slotId == slotId)
+                results.push_back(entry);
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const Entry& a, const Entry& b) { return a.sequence < b.sequence; });
+    return results;
+}
+
+} // namespace fesd
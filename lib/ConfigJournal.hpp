@@ -0,0 +1,49 @@
+#pragma once
+
+#include "types/Transaction.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fesd {
+
+// Last successful value of each replayable setting per slot, so a recovered port can be brought back
+// to the state the application left the devices in
+class ConfigJournal final
+{
+public:
+    struct Entry
+    {
+        uint16_t slotId;
+        uint64_t sequence; // Order the settings were last made in, which is the order they are replayed in
+        std::string command;
+        std::string query; // Reads the setting back
+        std::vector<std::string> values;
+    };
+
+    // True when any of the messages is recorded or invalidates a recorded setting
+    static bool tracks(const std::vector<std::string>& messages);
+    // True when the query response of an entry holds the values it sets
+    static bool matches(const Entry& entry, std::string_view response);
+
+    // Records the messages the device accepted and applies the invalidation rules
+    void record(const std::vector<std::string>& messages, const TransactionResults& results);
+    void record(const std::string& message);
+    // Queries that read back settings a relative command has changed, each answer is then given to refresh()
+    std::vector<std::string> takeStale(void);
+    void refresh(const std::string& query, std::string_view response);
+    // Settings of the slot in replay order
+    std::vector<Entry> entries(uint16_t slotId) const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<std::string, Entry> m_entries; // By command and address, e.g. "PATH:GAIN 0 RX"
+    std::vector<std::string> m_stale;
+    uint64_t m_sequence = 0;
+};
+
+} // namespace fesd
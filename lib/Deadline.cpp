@@ -0,0 +1,38 @@
+#include <fesd/Deadline.hpp>
+
+#include <algorithm>
+
+namespace {
+
+thread_local fesd::Deadline threadDeadline;
+
+} // namespace
+
+namespace fesd {
+
+DeadlineScope::DeadlineScope(std::chrono::steady_clock::time_point deadline)
+    : m_previous(threadDeadline)
+{
+    threadDeadline = current(deadline);
+}
+
+DeadlineScope::DeadlineScope(std::chrono::steady_clock::duration budget)
+    : DeadlineScope(std::chrono::steady_clock::now() + budget)
+{
+}
+
+DeadlineScope::~DeadlineScope()
+{
+    threadDeadline = m_previous;
+}
+
+Deadline DeadlineScope::current(Deadline deadline)
+{
+    if (!threadDeadline.has_value())
+        return deadline;
+    if (!deadline.has_value())
+        return threadDeadline;
+    return std::min(*threadDeadline, *deadline);
+}
+
+} // namespace fesd
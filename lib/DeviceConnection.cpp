@@ -1,15 +1,325 @@
 #include "DeviceConnection.hpp"
 #include <fesd/SC2470Commander.hpp>
+#include <fesd/types/Exception.hpp>
+#include "ConfigJournal.hpp"
 #include "SerialConsole.hpp"
-#include <mutex>
+#include "ShadowState.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string_view>
 #include <thread>
 
+namespace {
+
+// Commands the device is sent before the first response is read back
+const std::size_t DefaultPipelineDepth = 4;
+
+// Readiness probing after a reset, the interval doubles up to the maximum
+const std::chrono::milliseconds ProbeTimeout(250);
+const std::chrono::milliseconds InitialProbeInterval(50);
+const std::chrono::milliseconds MaxProbeInterval(500);
+
+// Answered by any device on the port, it needs no slot
+const std::string RecoveryProbe = "VER";
+
+// Requests made by a recovery go through while the other ones are held
+thread_local bool recoveryThread = false;
+
+// Settings that make the device relock its PLLs before it answers
+const std::set<std::string_view> RetuneCommands = {
+    "PATH:FREQ",
+    "LOCLK:FREQ",
+    "REFPLL:CONFIG",
+    "SYN:REFFREQ",
+    "SYN:AUTOREF",
+    "SYN:REFSRC",
+    "SYN:FFRAC",
+    "CONFIG:APPLY",
+};
+
+// Commands that read or write the device's non-volatile memory
+const std::set<std::string_view> NvmCommands = {
+    "CONFIG:SAVE",
+    "CONFIG:LOAD",
+    "CONFIG:DEFAULT",
+};
+
+std::chrono::milliseconds responseTimeout(std::string_view message, const fesd::CommandTimeouts& timeouts)
+{
+    const std::string_view mnemonic = message.substr(0, message.find(' '));
+    if (mnemonic.ends_with('?'))
+        return timeouts.fast;
+    if (NvmCommands.count(mnemonic) > 0)
+        return timeouts.nvm;
+    if (RetuneCommands.count(mnemonic) > 0)
+        return timeouts.retune;
+    return timeouts.fast;
+}
+
+using ShadowStates = std::vector<std::shared_ptr<fesd::ShadowState>>;
+
+void recordShadows(const ShadowStates& shadows, const std::vector<std::string>& messages, const fesd::TransactionResults& results)
+{
+    for (const auto& shadow : shadows)
+        shadow->record(messages, results);
+}
+
+// Journals the settings of an asynchronous transaction once it has completed, settings changed by a relative command
+// are read back by the next synchronous one
+fesd::AsyncResult<fesd::TransactionResults> recordWhenDone(fesd::AsyncResult<fesd::TransactionResults> result, std::vector<std::string> messages, std::shared_ptr<fesd::ConfigJournal> journal, ShadowStates shadows)
+{
+    fesd::TransactionResults results;
+    try
+    {
+        results = co_await result;
+    }
+    catch (...)
+    {
+        // Settings the device may or may not have made are no longer known
+        recordShadows(shadows, messages, {});
+        throw;
+    }
+    if (journal)
+        journal->record(messages, results);
+    recordShadows(shadows, messages, results);
+    co_return results;
+}
+
+} // namespace
+
 namespace fesd {
 
 struct DeviceConnection::Detail {
+    // Shared with the lost handler, which the reactor may still call while the connection goes away
+    struct Recovery
+    {
+        std::mutex mutex;
+        std::condition_variable wake;
+        RecoverySettings settings;
+        RestoreHandler restore;
+        bool lost = false;
+        bool stopping = false;
+    };
+
+    std::shared_ptr<Recovery> recovery = std::make_shared<Recovery>();
     SerialConsole serial;
-    std::mutex mutex;
+    std::shared_ptr<ConfigJournal> journal = std::make_shared<ConfigJournal>();
+    mutable std::mutex shadowMutex;
+    std::map<uint16_t, std::shared_ptr<ShadowState>> shadows;
+    std::atomic<std::size_t> pipelineDepth = DefaultPipelineDepth;
+    mutable std::mutex settingsMutex;
+    CommandTimeouts timeouts;
+    std::thread recoveryWorker;
+
+    Detail(std::string port)
+        : serial(std::move(port),
+            [weak = std::weak_ptr<Recovery>(recovery)]()
+            {
+                const std::shared_ptr<Recovery> state = weak.lock();
+                if (!state)
+                    return false;
+
+                std::scoped_lock<std::mutex> lock(state->mutex);
+                if (!state->settings.enabled || state->stopping)
+                    return false;
+                state->lost = true;
+                state->wake.notify_all();
+                return true;
+            }
+        )
+    {
+    }
+
+    ~Detail()
+    {
+        stop();
+
+        // The worker drops the last reference once a restore is over, it only touches the shared recovery state after that
+        if (recoveryWorker.joinable() && recoveryWorker.get_id() == std::this_thread::get_id())
+            recoveryWorker.detach();
+        else if (recoveryWorker.joinable())
+            recoveryWorker.join();
+    }
+
+    // Ends a restore in progress and the recovery worker
+    void stop(void)
+    {
+        {
+            std::scoped_lock<std::mutex> lock(recovery->mutex);
+            recovery->stopping = true;
+        }
+        recovery->wake.notify_all();
+    }
+
+    // Transacts and journals the settings the device accepted, queries the shadow states all hold are answered from them
+    TransactionResults execute(std::vector<std::string> messages, Deadline deadline, CommandPriority priority) const
+    {
+        const ShadowStates shadowStates = attachedShadows();
+        if (std::optional<TransactionResults> answers = shadowed(shadowStates, messages))
+            return std::move(*answers);
+
+        const bool journaled = ConfigJournal::tracks(messages);
+        if (!journaled && shadowStates.empty())
+            return serial.execute(makeRequest(std::move(messages), deadline, priority));
+
+        TransactionResults results;
+        try
+        {
+            results = serial.execute(makeRequest(messages, deadline, priority));
+        }
+        catch (...)
+        {
+            recordShadows(shadowStates, messages, {});
+            throw;
+        }
+        recordShadows(shadowStates, messages, results);
+        if (!journaled)
+            return results;
+        journal->record(messages, results);
+
+        for (const std::string& query : journal->takeStale())
+        {
+            TransactionResults current = serial.execute(makeRequest({query}, deadline, priority));
+            recordShadows(shadowStates, {query}, current);
+            if (current.front().success)
+                journal->refresh(query, current.front().response);
+        }
+        return results;
+    }
+
+    ShadowStates attachedShadows(void) const
+    {
+        ShadowStates results;
+        std::scoped_lock<std::mutex> lock(shadowMutex);
+        for (const auto& [slotId, shadow] : shadows)
+            results.push_back(shadow);
+        return results;
+    }
+
+    // Answers when every message is a query a shadow state holds, unless the calling thread refreshes them
+    static std::optional<TransactionResults> shadowed(const ShadowStates& shadowStates, const std::vector<std::string>& messages)
+    {
+        if (shadowStates.empty() || ShadowState::Refresh::active())
+            return std::nullopt;
+
+        TransactionResults results;
+        for (const std::string& message : messages)
+        {
+            std::optional<std::string> answer;
+            for (auto shadow = shadowStates.begin(); !answer && shadow != shadowStates.end(); shadow++)
+                answer = (*shadow)->lookup(message);
+            if (!answer)
+                return std::nullopt;
+            results.push_back({true, std::move(*answer)});
+        }
+        return results;
+    }
+
+    std::unique_ptr<SerialConsole::Request> makeRequest(std::vector<std::string> messages, Deadline deadline, CommandPriority priority = CommandPriority::Control) const
+    {
+        auto request = std::make_unique<SerialConsole::Request>();
+        {
+            std::scoped_lock<std::mutex> lock(settingsMutex);
+            for (const std::string& message : messages)
+                request->timeouts.push_back(responseTimeout(message, timeouts));
+        }
+        request->messages = std::move(messages);
+        request->window = pipelineDepth;
+        request->deadline = DeadlineScope::current(deadline);
+        request->cancellation = CancellationScope::current();
+        request->recovery = recoveryThread;
+        request->priority = priority;
+        return request;
+    }
+
+    void control(SerialConsole::Request::Kind kind) const
+    {
+        auto request = std::make_unique<SerialConsole::Request>();
+        request->kind = kind;
+        serial.execute(std::move(request));
+    }
+
+    // Waits for the interval unless the connection is going away, returns false if it is
+    bool pause(std::chrono::milliseconds interval) const
+    {
+        std::unique_lock<std::mutex> lock(recovery->mutex);
+        return !recovery->wake.wait_for(lock, interval, [this]() { return recovery->stopping; });
+    }
+
+    // Waits without holding the connection, which is only kept alive while a restore runs.
+    // The restore handler may then release the last reference to it, the restore still completes.
+    static void recoverLostPorts(std::shared_ptr<Recovery> recovery, std::weak_ptr<Detail> weakDetail)
+    {
+        recoveryThread = true;
+        while (true)
+        {
+            RecoverySettings settings;
+            {
+                std::unique_lock<std::mutex> lock(recovery->mutex);
+                recovery->wake.wait(lock, [&recovery]() { return recovery->lost || recovery->stopping; });
+                if (recovery->stopping)
+                    return;
+                recovery->lost = false;
+                settings = recovery->settings;
+            }
+
+            const std::shared_ptr<Detail> detail = weakDetail.lock();
+            if (!detail)
+                return;
+            detail->restore(settings);
+        }
+    }
+
+    // Reopens the port until the restore handler is satisfied with the devices on it, then releases the held requests
+    void restore(const RecoverySettings& settings)
+    {
+        const auto lostTime = std::chrono::steady_clock::now();
+        std::chrono::milliseconds interval = InitialProbeInterval;
+        bool rejecting = false;
+
+        while (pause(interval))
+        {
+            interval = std::min(interval * 2, MaxProbeInterval);
+            try
+            {
+                auto request = std::make_unique<SerialConsole::Request>();
+                request->kind = SerialConsole::Request::Kind::Probe;
+                request->messages = {RecoveryProbe};
+                request->timeouts = {ProbeTimeout};
+                request->recovery = true;
+                serial.execute(std::move(request));
+
+                RestoreHandler handler;
+                {
+                    std::scoped_lock<std::mutex> lock(recovery->mutex);
+                    handler = recovery->restore;
+                }
+                // The devices may have lost their settings with the port
+                for (const auto& shadow : attachedShadows())
+                    shadow->clear();
+                if (handler)
+                    handler();
+
+                control(SerialConsole::Request::Kind::Release);
+                return;
+            }
+            catch (const std::exception&)
+            {
+            }
+
+            // Calls stop waiting, they fail until the port is back
+            if (!rejecting && std::chrono::steady_clock::now() - lostTime >= settings.timeout)
+            {
+                control(SerialConsole::Request::Kind::Reject);
+                rejecting = true;
+            }
+        }
+    }
 };
 
 [[nodiscard]] DeviceConnection::sptr DeviceConnection::make(std::string port)
@@ -18,27 +328,221 @@ struct DeviceConnection::Detail {
 }
 
 DeviceConnection::DeviceConnection(std::string port)
-    : m_detail(std::make_unique<Detail>(port))
+    : m_detail(std::make_shared<Detail>(port))
+{
+}
+
+DeviceConnection::~DeviceConnection()
 {
+    // A restore in progress holds the detail until it gives up
+    m_detail->stop();
 }
-DeviceConnection::~DeviceConnection() = default;
 
-std::string DeviceConnection::transact(const std::string& message) const
+std::string DeviceConnection::transact(const std::string& message, Deadline deadline, CommandPriority priority) const
 {
-    std::scoped_lock<std::mutex> lock(m_detail->mutex);
-    return m_detail->serial.transact(message);
+    TransactionResults results = m_detail->execute({message}, deadline, priority);
+    results.front().value();
+    return std::move(results.front().response);
 }
 
-void DeviceConnection::resetConnection(const std::string& notifyMessage) const
+TransactionResults DeviceConnection::transact(const std::vector<std::string>& messages, Deadline deadline, CommandPriority priority) const
 {
-    std::scoped_lock<std::mutex> lock(m_detail->mutex);
+    return m_detail->execute(messages, deadline, priority);
+}
 
+AsyncResult<TransactionResults> DeviceConnection::transactAsync(std::vector<std::string> messages, Deadline deadline, CommandPriority priority) const
+{
+    ShadowStates shadowStates = m_detail->attachedShadows();
+    if (std::optional<TransactionResults> answers = Detail::shadowed(shadowStates, messages))
+    {
+        AsyncCompletion<TransactionResults> completion;
+        completion.setValue(std::move(*answers));
+        return completion.result();
+    }
+
+    const bool journaled = ConfigJournal::tracks(messages);
+    if (!journaled && shadowStates.empty())
+        return m_detail->serial.submitAsync(m_detail->makeRequest(std::move(messages), deadline, priority));
+
+    AsyncResult<TransactionResults> result = m_detail->serial.submitAsync(m_detail->makeRequest(messages, deadline, priority));
+    return recordWhenDone(std::move(result), std::move(messages), journaled ? m_detail->journal : nullptr, std::move(shadowStates));
+}
+
+AsyncResult<TransactionResults> DeviceConnection::transactTimedAsync(std::vector<std::string> messages, WrittenHandler onWritten, Deadline deadline) const
+{
+    ShadowStates shadowStates = m_detail->attachedShadows();
+    const bool journaled = ConfigJournal::tracks(messages);
+    std::unique_ptr<SerialConsole::Request> request = m_detail->makeRequest(messages, deadline);
+    request->written = std::move(onWritten);
+
+    AsyncResult<TransactionResults> result = m_detail->serial.submitAsync(std::move(request));
+    if (!journaled && shadowStates.empty())
+        return result;
+    return recordWhenDone(std::move(result), std::move(messages), journaled ? m_detail->journal : nullptr, std::move(shadowStates));
+}
+
+void DeviceConnection::cancelPending(void) const
+{
+    m_detail->serial.cancelPending();
+}
+
+std::chrono::microseconds DeviceConnection::getOpenLatency(void) const
+{
+    return m_detail->serial.openLatency();
+}
+
+void DeviceConnection::setPipelineDepth(std::size_t depth)
+{
+    m_detail->pipelineDepth = (depth == 0) ? 1 : depth;
+}
+
+std::size_t DeviceConnection::getPipelineDepth(void) const
+{
+    return m_detail->pipelineDepth;
+}
+
+void DeviceConnection::setCommandTimeouts(const CommandTimeouts& timeouts)
+{
+    std::scoped_lock<std::mutex> lock(m_detail->settingsMutex);
+    m_detail->timeouts = timeouts;
+}
+
+CommandTimeouts DeviceConnection::getCommandTimeouts(void) const
+{
+    std::scoped_lock<std::mutex> lock(m_detail->settingsMutex);
+    return m_detail->timeouts;
+}
+
+std::chrono::milliseconds DeviceConnection::resetConnection(const std::string& notifyMessage, const std::string& probeMessage) const
+{
     if (notifyMessage.length() > 0)
+    {
         m_detail->serial.write(notifyMessage);
+        m_detail->journal->record(notifyMessage);
+        recordShadows(m_detail->attachedShadows(), {notifyMessage}, {});
+    }
+    const auto resetTime = std::chrono::steady_clock::now();
     m_detail->serial.disconnect();
-    // 5s was not enough to account for NVM config load after device startup, 10s works
-    std::this_thread::sleep_for(std::chrono::seconds(10));
-    m_detail->serial.reconnect();
+
+    // Release the held requests, they fail or go through depending on the state the device is in
+    auto release = [this]() {
+        try
+        {
+            m_detail->serial.reconnect();
+        }
+        catch (const CommunicationError&)
+        {
+        }
+    };
+
+    // The device is ready once it has loaded its NVM config and answers again, which takes a few seconds.
+    // The caller's deadline and cancellation bound the wait as they do any other call.
+    const auto readyBy = DeadlineScope::current(resetTime + getCommandTimeouts().reboot).value();
+    const std::optional<CancellationToken> cancellation = CancellationScope::current();
+
+    // Cancelling wakes the backoff between probes
+    struct Wakeup
+    {
+        std::mutex mutex;
+        std::condition_variable cancelled;
+        bool set = false;
+    };
+    const auto wakeup = std::make_shared<Wakeup>();
+    if (cancellation.has_value())
+    {
+        cancellation->subscribe(wakeup.get(), [wakeup]() {
+            {
+                std::scoped_lock<std::mutex> lock(wakeup->mutex);
+                wakeup->set = true;
+            }
+            wakeup->cancelled.notify_all();
+        });
+    }
+    auto unsubscribe = [&]() {
+        if (cancellation.has_value())
+            cancellation->unsubscribe(wakeup.get());
+    };
+
+    std::chrono::milliseconds interval = InitialProbeInterval;
+    while (std::chrono::steady_clock::now() < readyBy)
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeup->mutex);
+            wakeup->cancelled.wait_until(lock, std::min<std::chrono::steady_clock::time_point>(std::chrono::steady_clock::now() + interval, readyBy), [&]() { return wakeup->set; });
+        }
+        interval = std::min(interval * 2, MaxProbeInterval);
+
+        auto request = std::make_unique<SerialConsole::Request>();
+        request->kind = SerialConsole::Request::Kind::Probe;
+        request->messages = {probeMessage};
+        request->timeouts = {ProbeTimeout};
+        request->deadline = readyBy;
+        request->cancellation = cancellation;
+        // Any answer means the device is back, the port stays open and the held requests go through
+        try
+        {
+            if (cancellation.has_value())
+                cancellation->throwIfCancelled();
+            m_detail->serial.execute(std::move(request));
+            unsubscribe();
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - resetTime);
+        }
+        catch (const CancellationError&)
+        {
+            unsubscribe();
+            release();
+            throw;
+        }
+        catch (const CommunicationError&)
+        {
+        }
+    }
+
+    unsubscribe();
+    release();
+    throw CommunicationError("Device did not become ready after reset...");
+}
+
+void DeviceConnection::setRecovery(const RecoverySettings& settings)
+{
+    std::scoped_lock<std::mutex> lock(m_detail->recovery->mutex);
+    m_detail->recovery->settings = settings;
+    if (settings.enabled && !m_detail->recoveryWorker.joinable())
+        m_detail->recoveryWorker = std::thread(&Detail::recoverLostPorts, m_detail->recovery, std::weak_ptr<Detail>(m_detail));
+}
+
+void DeviceConnection::setRestoreHandler(RestoreHandler handler)
+{
+    std::scoped_lock<std::mutex> lock(m_detail->recovery->mutex);
+    m_detail->recovery->restore = std::move(handler);
+}
+
+std::size_t DeviceConnection::replayConfig(uint16_t slotId) const
+{
+    // One at a time in the order they were made, a setting can change the ones that follow it
+    std::size_t sent = 0;
+    for (const ConfigJournal::Entry& entry : m_detail->journal->entries(slotId))
+    {
+        TransactionResults current = m_detail->serial.execute(m_detail->makeRequest({entry.query}, std::nullopt));
+        if (current.front().success && ConfigJournal::matches(entry, current.front().response))
+            continue;
+
+        TransactionResults results = m_detail->serial.execute(m_detail->makeRequest({entry.command}, std::nullopt));
+        recordShadows(m_detail->attachedShadows(), {entry.command}, results);
+        results.front().value();
+        sent++;
+    }
+    return sent;
+}
+
+
+void DeviceConnection::attachShadowState(uint16_t slotId, std::shared_ptr<ShadowState> shadow)
+{
+    std::scoped_lock<std::mutex> lock(m_detail->shadowMutex);
+    if (shadow)
+        m_detail->shadows[slotId] = std::move(shadow);
+    else
+        m_detail->shadows.erase(slotId);
 }
 
 } // namespace fesd
@@ -1,26 +1,66 @@
 #pragma once
 
+#include "types/Transaction.hpp"
+
+#include <fesd/Async.hpp>
+#include <fesd/Cancellation.hpp>
+#include <fesd/Deadline.hpp>
 #include <fesd/types/Common.hpp>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
 
 namespace fesd {
 
 class BaseCommander;
+class ShadowState;
 
 class DeviceConnection final
 {
 public:
     using sptr = std::shared_ptr<DeviceConnection>;
+    // Runs on the recovery thread once a lost port has been reopened, before the held requests are released.
+    // Throws to fail the attempt, the port is then reopened again.
+    using RestoreHandler = std::function<void(void)>;
     [[nodiscard]] static sptr make(std::string port);
     ~DeviceConnection();
-    std::string transact(const std::string& message) const;
-    void resetConnection(const std::string& notifyMessage) const;
+    // Each response is given the timeout of its command class, the deadline bounds the whole transaction.
+    // The earlier of the deadline and the one of the calling thread's DeadlineScope applies, as does its CancellationScope.
+    // Telemetry waits for the control transactions queued on the port, so that monitoring does not delay them.
+    std::string transact(const std::string& message, Deadline deadline = std::nullopt, CommandPriority priority = CommandPriority::Control) const;
+    // Pipelined, writes up to the pipeline depth before reading and returns one result per message in order
+    TransactionResults transact(const std::vector<std::string>& messages, Deadline deadline = std::nullopt, CommandPriority priority = CommandPriority::Control) const;
+    // Same as the pipelined transact without blocking the caller
+    AsyncResult<TransactionResults> transactAsync(std::vector<std::string> messages, Deadline deadline = std::nullopt, CommandPriority priority = CommandPriority::Control) const;
+    // Called on the I/O thread when the first message has been written to the port, must not block or throw
+    using WrittenHandler = std::function<void(std::chrono::steady_clock::time_point time)>;
+    // Same as transactAsync, for commands whose time on the wire is measured. Never answered from the shadow state.
+    AsyncResult<TransactionResults> transactTimedAsync(std::vector<std::string> messages, WrittenHandler onWritten, Deadline deadline = std::nullopt) const;
+    // Fails every transaction queued on the port and abandons the one in flight, whichever device they are for
+    void cancelPending(void) const;
+    // Time the last open of the port took until the device was ready
+    std::chrono::microseconds getOpenLatency(void) const;
+    void setPipelineDepth(std::size_t depth);
+    std::size_t getPipelineDepth(void) const;
+    void setCommandTimeouts(const CommandTimeouts& timeouts);
+    CommandTimeouts getCommandTimeouts(void) const;
+    // Sends the reset message, then reopens the port and sends the probe with backoff until the device answers.
+    // Other requests are held meanwhile. Returns the time from the reset to the device being ready.
+    std::chrono::milliseconds resetConnection(const std::string& notifyMessage, const std::string& probeMessage) const;
+    // A port that fails with an I/O error is reopened in the background while calls wait for it
+    void setRecovery(const RecoverySettings& settings);
+    void setRestoreHandler(RestoreHandler handler);
+    // Sends the settings last made on the slot that differ from the ones the device has now, returns the number sent
+    std::size_t replayConfig(uint16_t slotId) const;
+    // Answers the slot's queries from the shadow state and keeps it up to date with the port's traffic, null detaches it
+    void attachShadowState(uint16_t slotId, std::shared_ptr<ShadowState> shadow);
 
 private:
     struct Detail;
-    std::unique_ptr<Detail> m_detail;
+    std::shared_ptr<Detail> m_detail;
     DeviceConnection(std::string port);
 };
 
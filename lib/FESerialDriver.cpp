@@ -3,6 +3,8 @@
 
 #include "DeviceConnection.hpp"
 #include "GeneralProcessor.hpp"
+#include "ShadowState.hpp"
+#include "reactor/IoReactor.hpp"
 
 #include <boost/algorithm/string.hpp>
 #include <stdexcept>
@@ -11,6 +13,31 @@ namespace {
 
 const uint16_t maxSlotId = 1;
 
+// Keeps a shadow state of the device and fills it in with one pipelined read of every shadowed setting
+void attachShadowState(const std::shared_ptr<fesd::DeviceDetails>& device)
+{
+    if (device->shadow)
+        return;
+    device->shadow = std::make_shared<fesd::ShadowState>(device->slotId);
+    device->connection->attachShadowState(device->slotId, device->shadow);
+
+    // Settings that cannot be read now are read on first use
+    try
+    {
+        const fesd::ShadowState::Refresh refresh;
+        device->connection->transact(device->shadow->queries());
+    }
+    catch (const std::exception&)
+    {
+    }
+}
+
+void detachShadowState(const std::shared_ptr<fesd::DeviceDetails>& device)
+{
+    device->connection->attachShadowState(device->slotId, nullptr);
+    device->shadow.reset();
+}
+
 } // static namespace
 
 namespace fesd {
@@ -40,6 +67,7 @@ void FESerialDriver::AddPorts(const std::string& ports)
             continue;
         }
 
+        std::vector<std::weak_ptr<DeviceDetails>> found;
         for (uint16_t slotId = 0; slotId <= maxSlotId; slotId++)
         {
             std::shared_ptr<DeviceDetails> device = std::make_shared<DeviceDetails>(conn, slotId);
@@ -55,6 +83,9 @@ void FESerialDriver::AddPorts(const std::string& ports)
                     device->firmwareVersion = processor.getFwVersionConverted();
                     device->hardwareVersion = processor.getHwVersionConverted();
                     m_deviceMap.emplace(processor.getSerialNumber(), device);
+                    found.push_back(device);
+                    if (m_shadowState)
+                        attachShadowState(device);
                     break;
                 }
             }
@@ -63,6 +94,24 @@ void FESerialDriver::AddPorts(const std::string& ports)
                 continue;
             }
         }
+
+        // After a recovery the port must lead to the same devices, which then get their settings back
+        conn->setRestoreHandler(
+            [found]()
+            {
+                for (const auto& weakDevice : found)
+                {
+                    const std::shared_ptr<DeviceDetails> device = weakDevice.lock();
+                    if (!device)
+                        continue;
+
+                    const std::string serialNumber = GeneralProcessor(device).getSerialNumber();
+                    if (serialNumber != device->serialNumberStr)
+                        throw CommunicationError("Found device " + serialNumber + " instead of " + device->serialNumberStr);
+                    device->connection->replayConfig(device->slotId);
+                }
+            }
+        );
     }
 }
 
@@ -129,4 +178,39 @@ void FESerialDriver::AddPorts(const std::string& ports)
     return results;
 }
 
+void FESerialDriver::setPipelineDepth(uint16_t depth) const
+{
+    for(const auto& [serialNumber, device] : m_deviceMap)
+        device->connection->setPipelineDepth(depth);
+}
+
+void FESerialDriver::setCommandTimeouts(const CommandTimeouts& timeouts) const
+{
+    for(const auto& [serialNumber, device] : m_deviceMap)
+        device->connection->setCommandTimeouts(timeouts);
+}
+
+void FESerialDriver::setAutoRecovery(const RecoverySettings& settings) const
+{
+    for(const auto& [serialNumber, device] : m_deviceMap)
+        device->connection->setRecovery(settings);
+}
+
+void FESerialDriver::setShadowState(bool enable)
+{
+    m_shadowState = enable;
+    for(const auto& [serialNumber, device] : m_deviceMap)
+    {
+        if (enable)
+            attachShadowState(device);
+        else
+            detachShadowState(device);
+    }
+}
+
+void FESerialDriver::configureIoThreads(const IoThreadSettings& settings)
+{
+    IoReactor::instance().configure(settings);
+}
+
 } // namespace fesd
\ No newline at end of file
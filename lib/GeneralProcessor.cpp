@@ -1,49 +1,45 @@
 #include "GeneralProcessor.hpp"
 #include "MessageBuilder.hpp"
 #include "DeviceConnection.hpp"
+#include "ResponseParser.hpp"
+#include "Utility.hpp"
 #include <fesd/types/Exception.hpp>
 
-#include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <stdexcept>
-#include <map>
+#include <string_view>
 
 namespace {
 // Commands
-const std::string reset = "*RST";
-const std::string identification = "*IDN";
-const std::string getManuf = "MAINT:GETMANUF";
-const std::string sysRole = "SYS:ROLE";
-const std::string sysNumChannels = "SYS:NCHAN";
+constexpr std::string_view reset = "*RST";
+constexpr std::string_view identification = "*IDN";
+constexpr std::string_view getManuf = "MAINT:GETMANUF";
+constexpr std::string_view sysRole = "SYS:ROLE";
+constexpr std::string_view sysNumChannels = "SYS:NCHAN";
 
-const std::map<fesd::SystemRole, std::string> SystemRoleStringMap = {
+constexpr fesd::utility::Table<fesd::SystemRole, std::string_view, 2> SystemRoleStringMap = {{
     {fesd::SystemRole::Controller,      "MASTER"},
     {fesd::SystemRole::Peripheral,      "SLAVE"},
-};
+}};
 
-const std::map<fesd::DeviceType, std::string> DeviceTypeStringMap = {
+constexpr fesd::utility::Table<fesd::DeviceType, std::string_view, 1> DeviceTypeStringMap = {{
     {fesd::DeviceType::SC2470,          "SC2470"},
-};
+}};
 
-std::string returnSplitString(const std::string& message, const std::string& delim, uint16_t desiredIndex)
+// Major and minor version, 1.2 for 1.2.3
+double versionNumber(std::string_view version)
 {
-    std::vector<std::string> splitResult;
-
-    boost::split(splitResult, message, boost::is_any_of(delim));
-
-    if (desiredIndex < splitResult.size())
-        return boost::trim_left_copy(splitResult[desiredIndex]);
-    return "";
+    return fesd::ResponseParser::toNumber<double>(version.substr(0, version.find('.', version.find('.') + 1)));
 }
 } // static namespace
 
 
 namespace fesd {
 
-void GeneralProcessor::resetDevice() const
+std::chrono::milliseconds GeneralProcessor::resetDevice() const
 {
-    m_details->connection->resetConnection(MessageBuilder::buildCommand(reset, m_details->slotId));
-    // Verify connection
-    this->getId();
+    // Identification doubles as the readiness probe
+    return m_details->connection->resetConnection(MessageBuilder::buildCommand(reset, m_details->slotId), MessageBuilder::buildQuery(identification, m_details->slotId));
 }
 
 std::string GeneralProcessor::getId() const
@@ -53,34 +49,31 @@ std::string GeneralProcessor::getId() const
 
 std::string GeneralProcessor::getSerialNumber() const
 {
-    const std::string delim(" ");
-    // index 0
-    const std::string result = returnSplitString(m_details->connection->transact(MessageBuilder::buildQuery(getManuf, m_details->slotId)), delim, 0);
-    return boost::trim_left_copy_if(result, boost::is_any_of("#H"));
+    const std::string response = m_details->connection->transact(MessageBuilder::buildQuery(getManuf, m_details->slotId));
+    std::string_view result = ResponseParser::field(response, ' ', 0);
+    result.remove_prefix(std::min(result.find_first_not_of("#H"), result.size()));
+    return std::string(result);
 }
 
 uint32_t GeneralProcessor::getSerialNumberConverted() const
 {
-    return std::stoul(this->getSerialNumber(), nullptr, 16);
+    return ResponseParser::toNumber<uint32_t>(this->getSerialNumber(), 16);
 }
 
 std::string GeneralProcessor::getHwVersion() const
 {
-    const std::string delim(" ");
-    // index 2
-    return returnSplitString(m_details->connection->transact(MessageBuilder::buildQuery(getManuf, m_details->slotId)), delim, 2);
+    return std::string(ResponseParser::field(m_details->connection->transact(MessageBuilder::buildQuery(getManuf, m_details->slotId)), ' ', 2));
 }
 
 double GeneralProcessor::getHwVersionConverted() const
 {
-    return std::stod(this->getHwVersion());
+    return versionNumber(this->getHwVersion());
 }
 
 DeviceType GeneralProcessor::getDeviceType() const
 {
-    const std::string delim(",");
-    // index 1
-    const std::string result = returnSplitString(m_details->connection->transact(MessageBuilder::buildQuery(identification, m_details->slotId)), delim, 1);
+    const std::string response = m_details->connection->transact(MessageBuilder::buildQuery(identification, m_details->slotId));
+    const std::string_view result = ResponseParser::field(response, ',', 1);
 
     for(const auto& [key, value] : DeviceTypeStringMap)
     {
@@ -94,14 +87,12 @@ DeviceType GeneralProcessor::getDeviceType() const
 
 std::string GeneralProcessor::getFwVersion() const
 {
-    const std::string delim(",");
-    // index 3
-    return returnSplitString(m_details->connection->transact(MessageBuilder::buildQuery(identification, m_details->slotId)), delim, 3);
+    return std::string(ResponseParser::field(m_details->connection->transact(MessageBuilder::buildQuery(identification, m_details->slotId)), ',', 3));
 }
 
 double GeneralProcessor::getFwVersionConverted() const
 {
-    return std::stod(this->getFwVersion());
+    return versionNumber(this->getFwVersion());
 }
 
 SystemRole GeneralProcessor::getSystemRole() const
@@ -120,13 +111,12 @@ SystemRole GeneralProcessor::getSystemRole() const
 
 void GeneralProcessor::setSystemRole(SystemRole role) const
 {
-    std::vector<std::string> params {SystemRoleStringMap.at(role)};
-    m_details->connection->transact(MessageBuilder::buildCommand(sysRole, m_details->slotId, params));
+    m_details->connection->transact(MessageBuilder::buildCommand(sysRole, m_details->slotId, {fesd::utility::at(SystemRoleStringMap, role)}));
 }
 
 uint16_t GeneralProcessor::getNumberOfDevices() const
 {
-    return static_cast<uint16_t>(std::stoul(m_details->connection->transact(MessageBuilder::buildQuery(sysNumChannels, m_details->slotId))));
+    return ResponseParser::value<uint16_t>(m_details->connection->transact(MessageBuilder::buildQuery(sysNumChannels, m_details->slotId)));
 }
 
 std::shared_ptr<DeviceDetails> GeneralProcessor::getDeviceDetails() const
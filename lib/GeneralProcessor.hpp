@@ -4,6 +4,7 @@
 
 #include <fesd/types/Common.hpp>
 
+#include <chrono>
 #include <string>
 
 namespace fesd {
@@ -14,7 +15,7 @@ public:
     GeneralProcessor(std::shared_ptr<DeviceDetails> details) : m_details(details) {};
 
 public:
-    void resetDevice() const;
+    std::chrono::milliseconds resetDevice() const;
     std::string getId() const;
     std::string getSerialNumber() const;
     uint32_t getSerialNumberConverted() const;
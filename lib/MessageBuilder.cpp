@@ -1,70 +1,202 @@
 #include "MessageBuilder.hpp"
+#include "Utility.hpp"
 #include <fesd/types/SC2470.hpp>
+#include <fesd/types/Exception.hpp>
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace {
 
 // Special Characters
-const std::string queryCharacter = "?";
-const std::string paramDelim = " ";
+const char queryCharacter = '?';
+const char paramDelim = ' ';
 
-const std::map<fesd::SC2470::Path, std::string> PathStringMap = {
+// Longest message that is built, the console's own line buffer is shorter
+const std::size_t MaxMessageSize = 256;
+// Decimals the console takes for fractional values
+const int RealPrecision = 6;
+
+constexpr fesd::utility::Table<fesd::SC2470::Path, std::string_view, 2> PathStringMap = {{
     {fesd::SC2470::Path::RX,    "RX"},
     {fesd::SC2470::Path::TX,    "TX"},
+}};
+
+// Appends to a message on the stack, the message is only copied out once complete
+class Encoder final
+{
+public:
+    void append(std::string_view text)
+    {
+        if (text.size() > m_buffer.size() - m_size)
+            tooLong();
+        std::memcpy(m_buffer.data() + m_size, text.data(), text.size());
+        m_size += text.size();
+    }
+
+    void append(char character)
+    {
+        append(std::string_view(&character, 1));
+    }
+
+    void append(const fesd::MessageParam& param)
+    {
+        const std::to_chars_result result = param.format(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size());
+        if (result.ec != std::errc())
+            tooLong();
+        m_size = result.ptr - m_buffer.data();
+    }
+
+    void appendHeader(std::string_view command, bool query, uint16_t channelId)
+    {
+        append(command);
+        if (query)
+            append(queryCharacter);
+        append(paramDelim);
+        append(fesd::MessageParam(channelId));
+        append(paramDelim);
+    }
+
+    void appendParams(fesd::MessageBuilder::Params params)
+    {
+        for (const fesd::MessageParam& param : params)
+        {
+            append(param);
+            append(paramDelim);
+        }
+    }
+
+    std::string_view view(void) const
+    {
+        return std::string_view(m_buffer.data(), m_size);
+    }
+
+    std::string str(void) const
+    {
+        return std::string(view());
+    }
+
+private:
+    [[noreturn]] static void tooLong(void)
+    {
+        throw fesd::InvalidArgumentsError("Message too long...");
+    }
+
+    std::array<char, MaxMessageSize> m_buffer;
+    std::size_t m_size = 0;
 };
 
+void appendAddress(Encoder& encoder, std::string_view command, bool query, uint16_t channelId, const fesd::SC2470::Path* path)
+{
+    encoder.appendHeader(command, query, channelId);
+    if (path != nullptr)
+    {
+        encoder.append(fesd::utility::at(PathStringMap, *path));
+        encoder.append(paramDelim);
+    }
+}
+
+std::string build(std::string_view command, bool query, uint16_t channelId, const fesd::SC2470::Path* path, fesd::MessageBuilder::Params params)
+{
+    Encoder encoder;
+    appendAddress(encoder, command, query, channelId, path);
+    encoder.appendParams(params);
+    return encoder.str();
+}
+
 } // static namespace
 
 namespace fesd {
 
-std::string MessageBuilder::buildCommand(const std::string& command, uint16_t channelId, const std::vector<std::string>& additionalParams)
+MessageParam MessageParam::hex(uint64_t value)
 {
-    std::string message = command + paramDelim + std::to_string(channelId) + paramDelim;
-    for(const std::string& param : additionalParams)
-        message += param + paramDelim;
-    return message;
+    MessageParam param(value);
+    param.m_kind = Kind::Hex;
+    return param;
 }
 
-std::string MessageBuilder::buildCommand(const std::string& command, uint16_t channelId, SC2470::Path path, const std::vector<std::string>& additionalParams)
+std::to_chars_result MessageParam::format(char* first, char* last) const
 {
-    std::vector<std::string> copyAdditionalParams = additionalParams;
-    copyAdditionalParams.insert(copyAdditionalParams.begin(), PathStringMap.at(path));
-    return buildCommand(command, channelId, copyAdditionalParams);
+    switch (m_kind)
+    {
+    case Kind::Signed:
+        return std::to_chars(first, last, m_signed);
+    case Kind::Unsigned:
+        return std::to_chars(first, last, m_unsigned);
+    case Kind::Hex:
+        if (last - first < 2)
+            return {last, std::errc::value_too_large};
+        *first++ = '0';
+        *first++ = 'x';
+        return std::to_chars(first, last, m_unsigned, 16);
+    case Kind::Real:
+    {
+        std::to_chars_result result = std::to_chars(first, last, m_real, std::chars_format::fixed, RealPrecision);
+        if (result.ec != std::errc() || std::find(first, result.ptr, '.') == result.ptr)
+            return result;
+
+        // Trailing zeroes and a bare decimal point carry nothing, negative zero is sent as zero
+        while (result.ptr[-1] == '0')
+            result.ptr--;
+        if (result.ptr[-1] == '.')
+            result.ptr--;
+        if (result.ptr - first == 2 && first[0] == '-' && first[1] == '0')
+        {
+            first[0] = '0';
+            result.ptr = first + 1;
+        }
+        return result;
+    }
+    case Kind::Text:
+    default:
+        if (static_cast<std::size_t>(last - first) < m_text.size())
+            return {last, std::errc::value_too_large};
+        std::memcpy(first, m_text.data(), m_text.size());
+        return {first + m_text.size(), std::errc()};
+    }
 }
 
-std::string MessageBuilder::buildCommand(const std::string& command, uint16_t channelId, SC2470::Path path)
+std::string MessageBuilder::buildCommand(std::string_view command, uint16_t channelId, Params additionalParams)
 {
-    return buildCommand(command, channelId, path, std::vector<std::string>());
+    return build(command, false, channelId, nullptr, additionalParams);
 }
 
-std::string MessageBuilder::buildCommand(const std::string& command, uint16_t channelId)
+std::string MessageBuilder::buildCommand(std::string_view command, uint16_t channelId, SC2470::Path path, Params additionalParams)
 {
-    return buildCommand(command, channelId, std::vector<std::string>());
+    return build(command, false, channelId, &path, additionalParams);
 }
 
-std::string MessageBuilder::buildQuery(const std::string& command, uint16_t channelId, const std::vector<std::string>& additionalParams)
+std::string MessageBuilder::buildQuery(std::string_view command, uint16_t channelId, Params additionalParams)
 {
-    std::string queryCommand = command + queryCharacter;
-    return buildCommand(queryCommand, channelId, additionalParams);
+    return build(command, true, channelId, nullptr, additionalParams);
 }
 
-std::string MessageBuilder::buildQuery(const std::string& command, uint16_t channelId, SC2470::Path path, const std::vector<std::string>& additionalParams)
+std::string MessageBuilder::buildQuery(std::string_view command, uint16_t channelId, SC2470::Path path, Params additionalParams)
 {
-    std::string queryCommand = command + queryCharacter;
-    return buildCommand(queryCommand, channelId, path, additionalParams);
+    return build(command, true, channelId, &path, additionalParams);
 }
 
-std::string MessageBuilder::buildQuery(const std::string& command, uint16_t channelId, SC2470::Path path)
+PreparedMessage::PreparedMessage(std::string_view command, uint16_t channelId, std::optional<SC2470::Path> path)
 {
-    std::string queryCommand = command + queryCharacter;
-    return buildCommand(queryCommand, channelId, path);
+    Encoder encoder;
+    appendAddress(encoder, command, false, channelId, path ? &*path : nullptr);
+    m_message.reserve(MaxMessageSize);
+    m_message.append(encoder.str());
+    m_headerSize = m_message.size();
 }
 
-std::string MessageBuilder::buildQuery(const std::string& command, uint16_t channelId)
+const std::string& PreparedMessage::patch(MessageBuilder::Params params)
 {
-    std::string queryCommand = command + queryCharacter;
-    return buildCommand(queryCommand, channelId);
+    Encoder encoder;
+    encoder.appendParams(params);
+    if (m_headerSize + encoder.view().size() > MaxMessageSize)
+        throw InvalidArgumentsError("Message too long...");
+
+    // Within the capacity reserved up front, so the message is never reallocated
+    m_message.resize(m_headerSize);
+    m_message.append(encoder.view());
+    return m_message;
 }
 
-} // namespace fesd
\ No newline at end of file
+} // namespace fesd
@@ -2,23 +2,96 @@
 
 #include <fesd/fesd.hpp>
 
+#include <charconv>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <type_traits>
 
 namespace fesd
 {
+
+// Parameter of a message, numbers are formatted straight into the message when it is built.
+// Floating point values keep the six decimals of the console and drop trailing zeroes, 12700000 rather than 12700000.000000.
+class MessageParam
+{
+public:
+    MessageParam(std::string_view text) : m_kind(Kind::Text), m_text(text) {}
+    MessageParam(const char* text) : MessageParam(std::string_view(text)) {}
+    MessageParam(const std::string& text) : MessageParam(std::string_view(text)) {}
+    MessageParam(bool value) : MessageParam(value ? std::string_view("1") : std::string_view("0")) {}
+    MessageParam(double value) : m_kind(Kind::Real), m_real(value) {}
+
+    template <typename T>
+        requires std::is_integral_v<T>
+    MessageParam(T value)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            m_kind = Kind::Signed;
+            m_signed = value;
+        }
+        else
+        {
+            m_kind = Kind::Unsigned;
+            m_unsigned = value;
+        }
+    }
+
+    // Sent as 0x followed by the value in hexadecimal
+    static MessageParam hex(uint64_t value);
+
+    std::to_chars_result format(char* first, char* last) const;
+
+private:
+    enum class Kind
+    {
+        Text,
+        Signed,
+        Unsigned,
+        Hex,
+        Real,
+    };
+
+    Kind m_kind;
+    union
+    {
+        int64_t m_signed = 0;
+        std::string_view m_text;
+        uint64_t m_unsigned;
+        double m_real;
+    };
+};
+
 class MessageBuilder
 {
 public:
     MessageBuilder(void){};
 public:
-    static std::string buildCommand(const std::string& command, uint16_t channelId, const std::vector<std::string>& additionalParams);
-    static std::string buildCommand(const std::string& command, uint16_t channelId, SC2470::Path path, const std::vector<std::string>& additionalParams);
-    static std::string buildCommand(const std::string& command, uint16_t channelId, SC2470::Path path);
-    static std::string buildCommand(const std::string& command, uint16_t channelId);
-    static std::string buildQuery(const std::string& command, uint16_t channelId, const std::vector<std::string>& additionalParams);
-    static std::string buildQuery(const std::string& command, uint16_t channelId, SC2470::Path path, const std::vector<std::string>& additionalParams);
-    static std::string buildQuery(const std::string& command, uint16_t channelId, SC2470::Path path);
-    static std::string buildQuery(const std::string& command, uint16_t channelId);
+    using Params = std::initializer_list<MessageParam>;
+
+    // Messages are formatted on the stack and only copied out once complete
+    static std::string buildCommand(std::string_view command, uint16_t channelId, Params additionalParams = {});
+    static std::string buildCommand(std::string_view command, uint16_t channelId, SC2470::Path path, Params additionalParams = {});
+    static std::string buildQuery(std::string_view command, uint16_t channelId, Params additionalParams = {});
+    static std::string buildQuery(std::string_view command, uint16_t channelId, SC2470::Path path, Params additionalParams = {});
+};
+
+// Command whose mnemonic, slot and path are encoded once. Each patch formats the parameters in place after them,
+// in a buffer allocated for the longest message, so a message sent again with new values costs no allocation.
+class PreparedMessage final
+{
+public:
+    PreparedMessage(std::string_view command, uint16_t channelId, std::optional<SC2470::Path> path = std::nullopt);
+
+    // Replaces the parameters and returns the whole message
+    const std::string& patch(MessageBuilder::Params params);
+    const std::string& str(void) const { return m_message; }
+
+private:
+    std::string m_message;
+    std::size_t m_headerSize;
 };
-} // namespace fesd
\ No newline at end of file
+} // namespace fesd
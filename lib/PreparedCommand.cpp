@@ -0,0 +1,17 @@
+#include "PreparedCommand.hpp"
+#include "DeviceConnection.hpp"
+
+namespace fesd {
+
+PreparedCommand::PreparedCommand(std::shared_ptr<DeviceDetails> details, std::string_view command, std::optional<SC2470::Path> path)
+    : m_details(std::move(details)),
+    m_message(command, m_details->slotId, path)
+{
+}
+
+void PreparedCommand::send(MessageBuilder::Params params)
+{
+    m_details->connection->transact(m_message.patch(params));
+}
+
+} // namespace fesd
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "MessageBuilder.hpp"
+#include "types/DeviceDetails.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace fesd {
+
+// Setting of one device encoded once and sent again with new values, see PreparedMessage.
+// Not to be used by several threads at once.
+class PreparedCommand final
+{
+public:
+    PreparedCommand(std::shared_ptr<DeviceDetails> details, std::string_view command, std::optional<SC2470::Path> path = std::nullopt);
+
+    void send(MessageBuilder::Params params);
+
+private:
+    std::shared_ptr<DeviceDetails> m_details;
+    PreparedMessage m_message;
+};
+
+} // namespace fesd
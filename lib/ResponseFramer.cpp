@@ -0,0 +1,150 @@
+#include "ResponseFramer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char CommandPrompt = '>';
+const std::string_view SuccessStatus = "OK";
+const std::string_view ErrorStatus = "ERR";
+
+inline bool isLineBreak(char c)
+{
+    return c == '\r' || c == '\n';
+}
+
+std::string_view trimLineBreaks(std::string_view text)
+{
+    while (!text.empty() && isLineBreak(text.front()))
+        text.remove_prefix(1);
+    while (!text.empty() && isLineBreak(text.back()))
+        text.remove_suffix(1);
+    return text;
+}
+
+// Status must be on its own line
+bool endsWithStatus(std::string_view text, std::string_view status)
+{
+    if (!text.ends_with(status))
+        return false;
+    const std::size_t start = text.size() - status.size();
+    return start == 0 || isLineBreak(text[start - 1]);
+}
+
+// Length of a "[ n ] " peripheral response prefix starting at first, 0 if there is none
+std::size_t peripheralPrefixLength(const char* first, const char* last)
+{
+    const char* it = first;
+    if ((last - it) < 6 || it[0] != '[' || it[1] != ' ')
+        return 0;
+
+    it += 2;
+    const char* digits = it;
+    while (it != last && *it >= '0' && *it <= '9')
+        ++it;
+
+    if (it == digits || (last - it) < 3 || it[0] != ' ' || it[1] != ']' || it[2] != ' ')
+        return 0;
+    return static_cast<std::size_t>(it + 3 - first);
+}
+
+// Removes all peripheral prefixes in place, returns the new end of the range
+char* stripPeripheralPrefixes(char* first, char* last)
+{
+    char* out = first;
+    for (char* in = first; in != last;)
+    {
+        if (*in == '[')
+        {
+            const std::size_t length = peripheralPrefixLength(in, last);
+            if (length > 0)
+            {
+                in += length;
+                continue;
+            }
+        }
+        *out++ = *in++;
+    }
+    return out;
+}
+
+} // namespace
+
+namespace fesd {
+
+ResponseFramer::ResponseFramer(std::size_t initialCapacity) : m_buffer(initialCapacity)
+{
+}
+
+std::span<char> ResponseFramer::prepare(std::size_t minimumSize)
+{
+    // Move any partial frame to the front so the buffer only grows while a single frame is larger than it
+    if (m_begin > 0)
+    {
+        std::copy(m_buffer.begin() + m_begin, m_buffer.begin() + m_end, m_buffer.begin());
+        m_end -= m_begin;
+        m_scan -= m_begin;
+        m_begin = 0;
+    }
+
+    if ((m_buffer.size() - m_end) < minimumSize)
+        m_buffer.resize(m_end + minimumSize);
+
+    return {m_buffer.data() + m_end, m_buffer.size() - m_end};
+}
+
+void ResponseFramer::commit(std::size_t count)
+{
+    m_end = std::min(m_end + count, m_buffer.size());
+}
+
+bool ResponseFramer::next(Frame& frame)
+{
+    if (m_scan == m_end)
+        return false;
+
+    char* data = m_buffer.data();
+    char* prompt = static_cast<char*>(std::memchr(data + m_scan, CommandPrompt, m_end - m_scan));
+    if (prompt == nullptr)
+    {
+        m_scan = m_end;
+        return false;
+    }
+
+    char* first = data + m_begin;
+    m_begin = static_cast<std::size_t>(prompt - data) + 1;
+    m_scan = m_begin;
+
+    // Remove any peripheral response overhead, then the status line
+    std::string_view text = trimLineBreaks({first, stripPeripheralPrefixes(first, prompt)});
+    frame.status = Status::None;
+    if (endsWithStatus(text, SuccessStatus))
+    {
+        frame.status = Status::Ok;
+        text.remove_suffix(SuccessStatus.size());
+    }
+    else if (endsWithStatus(text, ErrorStatus))
+    {
+        frame.status = Status::Error;
+        text.remove_suffix(ErrorStatus.size());
+    }
+    frame.payload = trimLineBreaks(text);
+
+    // Nothing left over, restart at the front without moving any bytes
+    if (m_begin == m_end)
+        m_begin = m_end = m_scan = 0;
+    return true;
+}
+
+void ResponseFramer::clear(void)
+{
+    m_begin = m_end = m_scan = 0;
+}
+
+std::size_t ResponseFramer::buffered(void) const
+{
+    return m_end - m_begin;
+}
+
+} // namespace fesd
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace fesd {
+
+// Incremental framer for device console responses.
+// Received bytes are appended to a persistent buffer, a frame is complete once the command prompt is seen.
+// Bytes received after a prompt are kept and become the start of the next frame.
+class ResponseFramer final
+{
+public:
+    enum class Status
+    {
+        Ok,
+        Error,
+        None, // Prompt received without an OK/ERR status line
+    };
+
+    struct Frame
+    {
+        Status status;
+        std::string_view payload;
+    };
+
+public:
+    ResponseFramer(std::size_t initialCapacity = 1024);
+
+    // Writable space at the end of the buffer, at least minimumSize bytes long. Invalidates any returned payload.
+    std::span<char> prepare(std::size_t minimumSize);
+    // Marks count bytes of the space returned by prepare() as received
+    void commit(std::size_t count);
+    // Extracts the next complete frame, payload points into the buffer and is valid until the next prepare() or clear()
+    bool next(Frame& frame);
+    // Drops all buffered bytes
+    void clear(void);
+    std::size_t buffered(void) const;
+
+private:
+    std::vector<char> m_buffer;
+    std::size_t m_begin = 0; // Start of the unconsumed bytes
+    std::size_t m_end = 0;   // End of the received bytes
+    std::size_t m_scan = 0;  // Bytes before this position are known not to contain a prompt
+};
+
+} // namespace fesd
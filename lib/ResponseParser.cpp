@@ -0,0 +1,58 @@
+#include "ResponseParser.hpp"
+
+namespace {
+
+const std::string_view Whitespace = " \t\r\n";
+
+std::string_view trim(std::string_view text)
+{
+    const std::size_t first = text.find_first_not_of(Whitespace);
+    if (first == std::string_view::npos)
+        return {};
+    return text.substr(first, text.find_last_not_of(Whitespace) - first + 1);
+}
+
+} // namespace
+
+namespace fesd {
+
+ResponseParser::ResponseParser(std::string_view response, char delimiter)
+    : m_rest(trim(response)), m_delimiter(delimiter), m_done(m_rest.empty())
+{
+}
+
+bool ResponseParser::done(void) const
+{
+    return m_done;
+}
+
+std::string_view ResponseParser::text(void)
+{
+    if (m_done)
+        invalid();
+
+    const std::size_t position = m_rest.find(m_delimiter);
+    const std::string_view field = m_rest.substr(0, position);
+    if (position == std::string_view::npos)
+    {
+        m_rest = {};
+        m_done = true;
+    }
+    else
+    {
+        m_rest.remove_prefix(position + 1);
+        if (m_delimiter == ' ')
+            m_rest = trim(m_rest);
+    }
+    return trim(field);
+}
+
+std::string_view ResponseParser::field(std::string_view response, char delimiter, std::size_t index)
+{
+    ResponseParser parser(response, delimiter);
+    for (std::size_t i = 0; i < index; i++)
+        parser.text();
+    return parser.text();
+}
+
+} // namespace fesd
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <fesd/types/Exception.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+
+namespace fesd {
+
+// Reads the fields of a response in place, without copying them. The response has to outlive the parser.
+// Fields are separated by the delimiter and trimmed of spaces, with the space delimiter a run of spaces separates two fields.
+// A missing or malformed field throws CommunicationError.
+class ResponseParser final
+{
+public:
+    explicit ResponseParser(std::string_view response, char delimiter = ' ');
+
+    // True once every field has been read
+    bool done(void) const;
+    std::string_view text(void);
+
+    // Next field as a number, string_view or std::string
+    template <typename T>
+    T next(void)
+    {
+        if constexpr (std::is_same_v<T, std::string_view>)
+            return text();
+        else if constexpr (std::is_same_v<T, std::string>)
+            return std::string(text());
+        else
+            return toNumber<T>(text());
+    }
+
+    // Leading fields of the response as the given types, fields after them are ignored
+    template <typename... T>
+    static std::tuple<T...> fields(std::string_view response, char delimiter = ' ')
+    {
+        ResponseParser parser(response, delimiter);
+        // Braced initialisation reads the fields from left to right
+        return std::tuple<T...>{parser.next<T>()...};
+    }
+
+    // First field of the response
+    template <typename T>
+    static T value(std::string_view response)
+    {
+        return ResponseParser(response).next<T>();
+    }
+
+    // Field at the index, counted from 0
+    static std::string_view field(std::string_view response, char delimiter, std::size_t index);
+
+    // The whole field has to be the number, a 0x prefix makes it hexadecimal
+    template <typename T>
+    static T toNumber(std::string_view field, int base = 10)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+        if (!field.empty() && field.front() == '+')
+            field.remove_prefix(1);
+        if (field.size() > 2 && field[0] == '0' && (field[1] == 'x' || field[1] == 'X'))
+        {
+            field.remove_prefix(2);
+            base = 16;
+        }
+
+        const char* const last = field.data() + field.size();
+        std::from_chars_result result;
+        T value{};
+        if constexpr (std::is_integral_v<T>)
+            result = std::from_chars(field.data(), last, value, base);
+        else if (base == 10)
+            result = std::from_chars(field.data(), last, value);
+        else
+        {
+            uint64_t integer = 0;
+            result = std::from_chars(field.data(), last, integer, base);
+            value = static_cast<T>(integer);
+        }
+
+        if (field.empty() || result.ec != std::errc() || result.ptr != last)
+            invalid();
+        return value;
+    }
+
+private:
+    [[noreturn]] static void invalid(void)
+    {
+        throw CommunicationError("Invalid response from device...");
+    }
+
+private:
+    std::string_view m_rest;
+    char m_delimiter;
+    bool m_done;
+};
+
+} // namespace fesd
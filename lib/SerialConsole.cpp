@@ -1,162 +1,745 @@
 #include "SerialConsole.hpp"
+#include "ResponseFramer.hpp"
+#include "reactor/IoReactor.hpp"
+#include "transport/Transport.hpp"
+#include <fesd/Async.hpp>
 #include <fesd/types/Exception.hpp>
 
-#include <regex>
-#include <stdexcept>
-#ifdef WIN32
-#include "wintargetsys.h" // required for boost/asio on windows, include before boost/asio
-#endif // WIN32
-#include <boost/asio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <boost/lockfree/queue.hpp>
 #include <chrono>
-#include <iostream>
+#include <deque>
+#include <string_view>
+#include <utility>
 
 namespace {
-const std::string CommandPrompt = ">";
-const std::regex SuccessRegex("(\r|\n)(OK)(\r|\n)\\" + CommandPrompt);
-const std::regex ErrorRegex("(\r|\n|)(ERR)(\r|\n)" + CommandPrompt);
-const std::regex PeripheralResponseRegex("(\\[ [0-9]+ \\] )");
+const std::string_view Termination = "\x0D";
+const std::string_view Etx = "\x03";
 const uint32_t ReadTimeoutSeconds = 10;
-
-using SerialSetting = boost::asio::serial_port_base;
-
-void InitSerialSettings(boost::asio::serial_port& serial)
-{
-    serial.set_option(SerialSetting::baud_rate(115200));
-    serial.set_option(SerialSetting::parity(SerialSetting::parity::even));
-    serial.set_option(SerialSetting::stop_bits(SerialSetting::stop_bits::one));
-    serial.set_option(SerialSetting::flow_control(SerialSetting::flow_control::none));
-}
+const uint32_t DrainTimeMilliseconds = 250;
+// Quiet time after which a port that was opened counts as drained when no prompt came back
+const uint32_t DrainIdleMilliseconds = 50;
+const std::size_t ReadChunkSize = 256;
+const std::size_t InboxCapacity = 64;
+// Control requests started in a row while telemetry waits, so a busy control loop cannot starve monitoring
+const std::size_t MaxControlBurst = 8;
 
 } // namespace
 
 namespace fesd {
 
-struct SerialConsole::Device
+// Reactor side of a port. Only submit() is called from other threads, everything else runs on the io_context thread.
+class SerialConsole::Session final : public std::enable_shared_from_this<Session>
 {
-    std::string port;
-    boost::asio::io_context io;
-    boost::asio::serial_port serial;
-    Device(std::string serialPort) : io(), serial(io) 
+public:
+    Session(const std::string& port, boost::asio::io_context& ioContext, LostHandler onLost)
+        : io(ioContext), m_transport(Transport::make(port, ioContext)), m_timer(ioContext), m_inbox(InboxCapacity), m_onLost(std::move(onLost))
     {
-        port = serialPort;
     }
-    ~Device() {}
-};
 
-SerialConsole::SerialConsole(std::string device) : m_dev(std::make_unique<Device>(device))
-{
-    this->connect();
-}
-SerialConsole::~SerialConsole() = default;
+    ~Session()
+    {
+        Request* request;
+        while (m_inbox.pop(request))
+            delete request;
+    }
 
-void SerialConsole::connect() const
-{
-    try
+    void submit(std::unique_ptr<Request> request)
     {
-        m_dev->serial.open(m_dev->port);
+        m_inbox.push(request.release());
+
+        // Only wake the reactor when it is not already going to drain the inbox
+        if (!m_scheduled.exchange(true))
+        {
+            boost::asio::post(io,
+                [self = shared_from_this()]()
+                {
+                    self->drainInbox();
+                }
+            );
+        }
     }
-    catch (...)
+
+    std::chrono::microseconds openLatency(void) const
     {
-        throw CommunicationError(std::string("Failed to open device " + m_dev->port));
+        return std::chrono::microseconds(m_openLatency.load());
     }
 
-    InitSerialSettings(m_dev->serial);
+    void cancelPending(void)
+    {
+        boost::asio::post(io,
+            [self = shared_from_this()]()
+            {
+                self->cancel(true);
+            }
+        );
+    }
 
-    // Clean out device buffer - ETX(0x03) will force device to clear its buffer
-    write("\x03");
+    boost::asio::io_context& io;
 
-    // Clean out PC / return buffers
-    try
-    {    
-        boost::asio::streambuf buffer;
-        m_dev->io.restart();
-        boost::asio::async_read_until(m_dev->serial, buffer, CommandPrompt, 
-            [](const boost::system::error_code& e, std::size_t size) 
+private:
+    using Kind = Request::Kind;
+
+    enum class State
+    {
+        Closed,
+        Open,
+        Failed,
+    };
+
+    enum class Recovery
+    {
+        None,
+        Holding,   // Requests wait for the recovery to release them
+        Rejecting, // Requests fail while the recovery carries on
+    };
+
+    void drainInbox(void)
+    {
+        m_scheduled = false;
+        takeInbox();
+        startNext();
+    }
+
+    void takeInbox(void)
+    {
+        Request* request;
+        while (m_inbox.pop(request))
+        {
+            watch(*request);
+            queueOf(request->priority).emplace_back(request);
+        }
+    }
+
+    // Cancelling the token brings the session back to the reactor to take the request out
+    void watch(const Request& request)
+    {
+        if (!request.cancellation)
+            return;
+
+        request.cancellation->subscribe(this,
+            [weak = weak_from_this()]()
             {
-                return; // Do nothing with results
+                if (auto self = weak.lock())
+                {
+                    boost::asio::post(self->io,
+                        [self]()
+                        {
+                            self->cancel(false);
+                        }
+                    );
+                }
             }
         );
-            
-        m_dev->io.run_for(std::chrono::milliseconds(250)); // Arbitrary time of 250ms
-        m_dev->io.restart();
     }
-    catch(...)
+
+    static bool transfer(const Request& request)
     {
-        throw CommunicationError("Serial communication error...");
+        return request.kind == Kind::Transact || request.kind == Kind::Write;
     }
-}
 
-void SerialConsole::disconnect(void) const
-{
-    m_dev->serial.cancel();
-    m_dev->serial.close();
-    m_dev->io.stop();
-}
+    // Probes of a reset are abandoned with the caller's other calls
+    static bool cancellable(const Request& request)
+    {
+        return transfer(request) || request.kind == Kind::Probe;
+    }
 
-void SerialConsole::reconnect(void) const
-{
-    this->connect();
-}
+    static bool cancelled(const Request& request)
+    {
+        return request.cancellation && request.cancellation->cancelled();
+    }
 
-std::string SerialConsole::transact(const std::string& message) const
-{
-   write(message);
-   std::string response = read();
+    // Fails the queued transfers that were cancelled, or all of them, and abandons the active one if it is among them
+    void cancel(bool all)
+    {
+        takeInbox();
+        for (auto* queue : {&m_control, &m_telemetry})
+        {
+            std::erase_if(*queue,
+                [all](const auto& request)
+                {
+                    if (!cancellable(*request) || !(all || cancelled(*request)))
+                        return false;
+                    fail(*request, CancellationError("Operation cancelled..."));
+                    return true;
+                }
+            );
+        }
 
-   if (std::regex_search(response, ErrorRegex))
-      throw InvalidArgumentsError("Command Error Returned");
+        if (m_active && !m_finishing && cancellable(*m_active) && (all || cancelled(*m_active)))
+        {
+            // Responses to what was written are still to come, the next request resynchronises first.
+            // Its ETX also makes the device drop the commands of this one it has not started on.
+            if (m_written > 0)
+                m_resync = true;
+            finish(std::make_exception_ptr(CancellationError("Operation cancelled...")));
+        }
+        startNext();
+    }
 
-   // Remove any peripheral response overhead, then
-   // Remove the leading new lines + status response
-   return std::regex_replace(std::regex_replace(response, PeripheralResponseRegex, ""), SuccessRegex, "");
-}
-void SerialConsole::write(const std::string& message) const
-{
-    const std::string termination = "\x0D";
-    try
+    std::deque<std::unique_ptr<Request>>& queueOf(CommandPriority priority)
+    {
+        return (priority == CommandPriority::Telemetry) ? m_telemetry : m_control;
+    }
+
+    std::deque<std::unique_ptr<Request>>::iterator firstRunnable(std::deque<std::unique_ptr<Request>>& queue)
     {
-        boost::asio::write(m_dev->serial, boost::asio::buffer(message + termination));
+        return std::find_if(queue.begin(), queue.end(),
+            [this](const auto& request)
+            {
+                return !held(*request);
+            }
+        );
     }
-    catch(...)
+
+    void startNext(void)
     {
-        throw CommunicationError("Serial communication error...");
+        while (!m_active)
+        {
+            // Control first, telemetry once no control request is ready or the burst limit is reached
+            const auto control = firstRunnable(m_control);
+            const auto telemetry = firstRunnable(m_telemetry);
+            const bool controlReady = control != m_control.end();
+            const bool telemetryReady = telemetry != m_telemetry.end();
+            if (!controlReady && !telemetryReady)
+                return;
+
+            if (controlReady && (!telemetryReady || m_controlBurst < MaxControlBurst))
+            {
+                m_controlBurst = telemetryReady ? m_controlBurst + 1 : 0;
+                m_active = std::move(*control);
+                m_control.erase(control);
+            }
+            else
+            {
+                m_controlBurst = 0;
+                m_active = std::move(*telemetry);
+                m_telemetry.erase(telemetry);
+            }
+            start();
+        }
     }
-}
 
-std::string SerialConsole::read(void) const
-{
-    boost::asio::streambuf buffer;
-    std::chrono::time_point readStart = std::chrono::steady_clock::now();
+    // Held until the port is connected again or the recovery of a lost port releases it
+    bool held(const Request& request) const
+    {
+        switch (request.kind)
+        {
+        case Kind::Connect:
+        case Kind::Probe:
+        case Kind::Shutdown:
+        case Kind::Reject:
+        case Kind::Release:
+            return false;
+        default:
+            break;
+        }
 
-    bool readComplete = false;
-    m_dev->io.restart();
-    try
-    { 
-        boost::asio::async_read_until(m_dev->serial, buffer, CommandPrompt, 
-            [&readComplete](const boost::system::error_code& e, std::size_t size) 
+        if (m_recovery == Recovery::Holding)
+            return !request.recovery;
+        return m_state == State::Closed && m_recovery == Recovery::None;
+    }
+
+    void start(void)
+    {
+        m_generation++;
+        m_written = 0;
+
+        switch (m_active->kind)
+        {
+        case Kind::Connect:
+        case Kind::Probe:
+            open();
+            return;
+        case Kind::Disconnect:
+            m_transport->close();
+            m_state = State::Closed;
+            finish(nullptr);
+            return;
+        case Kind::Shutdown:
+            m_transport->close();
+            m_state = State::Failed;
+            for (auto* queue : {&m_control, &m_telemetry})
+            {
+                for (auto& request : *queue)
+                    fail(*request, CommunicationError("Device " + m_transport->name() + " is not connected"));
+                queue->clear();
+            }
+            finish(nullptr);
+            return;
+        case Kind::Reject:
+            m_recovery = Recovery::Rejecting;
+            finish(nullptr);
+            return;
+        case Kind::Release:
+            m_recovery = Recovery::None;
+            finish(nullptr);
+            return;
+        case Kind::Write:
+        case Kind::Transact:
+            if (m_active->messages.empty())
             {
-                if (!e) 
-                    readComplete = true;
+                finish(nullptr);
+                return;
+            }
+            if (cancelled(*m_active))
+            {
+                finish(std::make_exception_ptr(CancellationError("Operation cancelled...")));
+                return;
+            }
+            if (m_state != State::Open || (m_recovery == Recovery::Rejecting && !m_active->recovery))
+            {
+                finish(std::make_exception_ptr(CommunicationError("Device " + m_transport->name() + " is not connected")));
+                return;
+            }
+            if (deadlinePassed())
+            {
+                finish(std::make_exception_ptr(CommunicationError("Deadline exceeded...")));
+                return;
+            }
+            if (m_resync)
+                resync(std::chrono::seconds(ReadTimeoutSeconds));
+            else
+                begin();
+            return;
+        }
+    }
+
+    // Sends the active request, pipelined up to its window
+    void begin(void)
+    {
+        writeMore();
+        if (m_active && m_active->kind != Kind::Write)
+        {
+            armResponseTimer();
+            pump();
+        }
+    }
+
+    // A response can still be on its way after a timeout. The ETX makes the device drop the commands it has not
+    // started on, the empty line is then answered with a bare prompt once the device is done with the current one.
+    // Command responses always carry a status line, so everything up to the first bare prompt is stale.
+    void resync(std::chrono::steady_clock::duration timeout)
+    {
+        m_resyncing = true;
+        m_buffers = {Etx, Termination};
+        startWrite();
+        armTimer(timeout);
+        pump();
+    }
+
+    void open(void)
+    {
+        m_openStart = std::chrono::steady_clock::now();
+        m_transport->close();
+        m_writeInFlight = true; // The open stands in for the first write
+        m_transport->asyncOpen(
+            [self = shared_from_this()](const boost::system::error_code& error, std::size_t)
+            {
+                self->m_writeInFlight = false;
+                self->onOpen(error);
             }
         );
+    }
 
-        while (!readComplete)
+    void onOpen(const boost::system::error_code& error)
+    {
+        if (m_finishing)
+        {
+            tryFinish();
+            return;
+        }
+        if (error)
         {
-            // Boost ASIO async, understanding the basics:
-            // https://www.boost.org/doc/libs/1_65_1/doc/html/boost_asio/overview/core/basics.html
-            m_dev->io.run_one_for(std::chrono::seconds(1));
-            if ((std::chrono::steady_clock::now() - readStart) > std::chrono::seconds(ReadTimeoutSeconds))
-                break;
+            m_state = (m_active->kind == Kind::Probe) ? State::Closed : State::Failed;
+            finish(std::make_exception_ptr(CommunicationError(std::string("Failed to open device " + m_transport->name()))));
+            return;
         }
+        m_state = State::Open;
+
+        // A probe only succeeds once the device answers, which a bare prompt alone does not prove
+        if (m_active->kind == Kind::Probe)
+        {
+            m_framer.clear();
+            resync(m_active->timeouts.empty() ? std::chrono::milliseconds(DrainTimeMilliseconds) : m_active->timeouts.front());
+            return;
+        }
+
+        // Clean out device buffer - ETX(0x03) will force device to clear its buffer, the empty line is answered with a prompt.
+        // The transport has flushed the kernel buffers, what still comes in before that prompt is stale.
+        m_framer.clear();
+        m_buffers = {Etx, Termination};
+        startWrite();
+        armDrainTimer();
+        pump();
     }
-    catch(...)
+
+    // Drained at the prompt, or once the port has been quiet for a while, within the drain time either way
+    void armDrainTimer(void)
+    {
+        armTimer(std::min<std::chrono::steady_clock::duration>(std::chrono::milliseconds(DrainIdleMilliseconds),
+            m_openStart + std::chrono::milliseconds(DrainTimeMilliseconds) - std::chrono::steady_clock::now()));
+    }
+
+    void opened(void)
     {
-        throw CommunicationError("Serial communication error...");
+        m_openLatency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_openStart).count();
     }
 
-    if (!readComplete) 
-        throw CommunicationError("Serial communication timeout...");
-    return std::string((std::istreambuf_iterator<char>(&buffer)), std::istreambuf_iterator<char>());
+    // Tops the pipeline window back up with a single write
+    void writeMore(void)
+    {
+        if (m_writeInFlight || m_finishing)
+            return;
+
+        const auto& messages = m_active->messages;
+        const std::size_t limit = (m_active->kind == Kind::Write) ? messages.size() : std::min(messages.size(), m_results.size() + std::max<std::size_t>(m_active->window, 1));
+        m_buffers.clear();
+        for (; m_written < limit; m_written++)
+        {
+            m_buffers.push_back(messages[m_written]);
+            m_buffers.push_back(Termination);
+        }
+        if (!m_buffers.empty())
+            startWrite();
+        else if (m_active->kind == Kind::Write)
+            finish(nullptr);
+    }
+
+    void startWrite(void)
+    {
+        m_writeInFlight = true;
+        m_transport->asyncWrite(m_buffers,
+            [self = shared_from_this()](const boost::system::error_code& error, std::size_t)
+            {
+                self->m_writeInFlight = false;
+                self->onWrite(error);
+            }
+        );
+    }
+
+    void onWrite(const boost::system::error_code& error)
+    {
+        if (m_finishing)
+            tryFinish();
+        else if (error)
+            lost();
+        else if (m_active->kind != Kind::Connect && !m_resyncing)
+        {
+            if (m_active->written)
+                std::exchange(m_active->written, nullptr)(std::chrono::steady_clock::now());
+            writeMore();
+        }
+    }
+
+    // Hands buffered frames to the active request, then keeps reading while it waits for more
+    void pump(void)
+    {
+        const uint64_t generation = m_generation;
+        ResponseFramer::Frame frame;
+        while (m_active && !m_finishing && m_generation == generation && m_framer.next(frame))
+            onFrame(frame);
+
+        if (m_active && !m_finishing && m_generation == generation && !m_readInFlight)
+        {
+            m_readInFlight = true;
+            m_transport->asyncRead(m_framer.prepare(ReadChunkSize),
+                [self = shared_from_this()](const boost::system::error_code& error, std::size_t size)
+                {
+                    self->m_readInFlight = false;
+                    self->onRead(error, size);
+                }
+            );
+        }
+    }
+
+    void onRead(const boost::system::error_code& error, std::size_t size)
+    {
+        // Bytes that raced a cancellation are kept for the next response
+        m_framer.commit(size);
+
+        if (m_finishing)
+            tryFinish();
+        else if (error && error != boost::asio::error::operation_aborted)
+            lost();
+        else if (m_active)
+        {
+            if (m_active->kind == Kind::Connect && size > 0)
+                armDrainTimer();
+            pump();
+        }
+    }
+
+    void onFrame(const ResponseFramer::Frame& frame)
+    {
+        const bool prompt = frame.status == ResponseFramer::Status::None && frame.payload.empty();
+        if (m_resyncing)
+        {
+            if (prompt)
+            {
+                m_resyncing = false;
+                m_resync = false;
+                if (m_active->kind == Kind::Probe)
+                    opened();
+                begin();
+            }
+            return;
+        }
+
+        // Prompt after the ETX, the connection is clean
+        if (m_active->kind == Kind::Connect)
+        {
+            if (prompt)
+            {
+                m_resync = false;
+                opened();
+                finish(nullptr);
+            }
+            return;
+        }
+
+        m_results.push_back({frame.status != ResponseFramer::Status::Error, std::string(frame.payload)});
+        if (m_results.size() == m_active->messages.size())
+        {
+            finish(nullptr);
+            return;
+        }
+        armResponseTimer();
+        writeMore();
+    }
+
+    // The device answers in order, the next response belongs to the first message without a result
+    void armResponseTimer(void)
+    {
+        const auto& timeouts = m_active->timeouts;
+        if (timeouts.empty())
+            armTimer(std::chrono::seconds(ReadTimeoutSeconds));
+        else
+            armTimer(timeouts[std::min(m_results.size(), timeouts.size() - 1)]);
+    }
+
+    // Never waits past the deadline of the active request
+    void armTimer(std::chrono::steady_clock::duration timeout)
+    {
+        std::chrono::steady_clock::time_point expiry = std::chrono::steady_clock::now() + timeout;
+        if (m_active && m_active->deadline)
+            expiry = std::min(expiry, *m_active->deadline);
+
+        m_timer.expires_at(expiry);
+        m_timer.async_wait(
+            [self = shared_from_this(), generation = m_generation](const boost::system::error_code& error)
+            {
+                if (!error && self->m_active && !self->m_finishing && self->m_generation == generation)
+                    self->onTimeout();
+            }
+        );
+    }
+
+    void onTimeout(void)
+    {
+        // The device did not answer the empty line in time, its prompt may still come and the next request resynchronises
+        if (m_active->kind == Kind::Connect)
+        {
+            m_resync = true;
+            opened();
+            finish(nullptr);
+            return;
+        }
+
+        // Outstanding responses may still arrive, they must not be taken for those of the next request
+        if (m_active->kind == Kind::Transact)
+            m_resync = true;
+        if (deadlinePassed())
+            finish(std::make_exception_ptr(CommunicationError("Deadline exceeded...")));
+        else
+            finish(std::make_exception_ptr(CommunicationError("Serial communication timeout...")));
+    }
+
+    // The port failed under the active request, a device that was unplugged or an adapter that re-enumerated
+    void lost(void)
+    {
+        const bool transfer = m_active->kind == Kind::Transact || m_active->kind == Kind::Write;
+        if (transfer && m_recovery == Recovery::None && m_onLost && m_onLost())
+        {
+            m_recovery = Recovery::Holding;
+            m_closeOnFinish = true;
+        }
+        finish(std::make_exception_ptr(CommunicationError("Serial communication error...")));
+    }
+
+    bool deadlinePassed(void) const
+    {
+        return m_active->deadline && std::chrono::steady_clock::now() >= *m_active->deadline;
+    }
+
+    // Completes the active request once no operation refers to its buffers any more
+    void finish(std::exception_ptr error)
+    {
+        m_finishing = true;
+        m_error = error;
+        m_timer.cancel();
+        if (m_readInFlight || m_writeInFlight)
+            m_transport->cancel();
+        tryFinish();
+    }
+
+    void tryFinish(void)
+    {
+        if (m_readInFlight || m_writeInFlight)
+            return;
+
+        if (m_active->kind == Kind::Connect)
+            m_framer.clear();
+        if (m_resyncing)
+        {
+            m_resyncing = false;
+            m_resync = true;
+        }
+        if (m_closeOnFinish || (m_active->kind == Kind::Probe && m_error))
+        {
+            // Lost or not back yet, requests stay held until a probe succeeds
+            m_transport->close();
+            m_framer.clear();
+            m_state = State::Closed;
+            m_resync = false;
+            m_closeOnFinish = false;
+        }
+
+        std::unique_ptr<Request> request = std::move(m_active);
+        TransactionResults results = std::move(m_results);
+        std::exception_ptr error = std::exchange(m_error, nullptr);
+        m_results.clear();
+        m_finishing = false;
+
+        if (request->completion)
+            request->completion(std::move(results), error);
+        startNext();
+    }
+
+    template <typename Error>
+    static void fail(Request& request, const Error& error)
+    {
+        if (request.completion)
+            request.completion({}, std::make_exception_ptr(error));
+    }
+
+private:
+    std::shared_ptr<Transport> m_transport;
+    ResponseFramer m_framer;
+    boost::asio::steady_timer m_timer;
+
+    boost::lockfree::queue<Request*> m_inbox;
+    std::atomic<bool> m_scheduled = false;
+    std::deque<std::unique_ptr<Request>> m_control;
+    std::deque<std::unique_ptr<Request>> m_telemetry;
+    std::size_t m_controlBurst = 0;
+
+    const LostHandler m_onLost;
+    State m_state = State::Closed;
+    Recovery m_recovery = Recovery::None;
+    bool m_closeOnFinish = false;
+    std::chrono::steady_clock::time_point m_openStart;
+    std::atomic<int64_t> m_openLatency = 0; // Microseconds, read by other threads
+    std::unique_ptr<Request> m_active;
+    uint64_t m_generation = 0;
+    std::size_t m_written = 0;
+    TransactionResults m_results;
+    std::exception_ptr m_error;
+    bool m_finishing = false;
+    bool m_resync = false;    // The next request has to resynchronise with the device first
+    bool m_resyncing = false;
+    bool m_readInFlight = false;
+    bool m_writeInFlight = false;
+    std::vector<std::string_view> m_buffers;
+};
+
+SerialConsole::SerialConsole(std::string device, LostHandler onLost)
+    : m_session(std::make_shared<Session>(device, IoReactor::instance().nextContext(), std::move(onLost)))
+{
+    this->reconnect();
+}
+
+SerialConsole::~SerialConsole()
+{
+    auto request = std::make_unique<Request>();
+    request->kind = Request::Kind::Shutdown;
+
+    // Wait for the port to be closed unless that would block the reactor itself
+    if (m_session->io.get_executor().running_in_this_thread())
+    {
+        submit(std::move(request));
+        return;
+    }
+
+    try
+    {
+        execute(std::move(request));
+    }
+    catch (...)
+    {
+    }
+}
+
+void SerialConsole::submit(std::unique_ptr<Request> request) const
+{
+    m_session->submit(std::move(request));
+}
+
+TransactionResults SerialConsole::execute(std::unique_ptr<Request> request) const
+{
+    if (m_session->io.get_executor().running_in_this_thread())
+        throw InvalidArgumentsError("Blocking calls cannot be made from an I/O thread");
+
+    AsyncResult<TransactionResults> result = submitAsync(std::move(request));
+    return result.get();
+}
+
+AsyncResult<TransactionResults> SerialConsole::submitAsync(std::unique_ptr<Request> request) const
+{
+    AsyncCompletion<TransactionResults> completion;
+    request->completion = [completion](TransactionResults&& results, std::exception_ptr error)
+    {
+        if (error)
+            completion.setException(error);
+        else
+            completion.setValue(std::move(results));
+    };
+
+    submit(std::move(request));
+    return completion.result();
+}
+
+void SerialConsole::disconnect(void) const
+{
+    auto request = std::make_unique<Request>();
+    request->kind = Request::Kind::Disconnect;
+    execute(std::move(request));
+}
+
+void SerialConsole::reconnect(void) const
+{
+    auto request = std::make_unique<Request>();
+    request->kind = Request::Kind::Connect;
+    execute(std::move(request));
+}
+
+std::chrono::microseconds SerialConsole::openLatency(void) const
+{
+    return m_session->openLatency();
+}
+
+void SerialConsole::cancelPending(void) const
+{
+    m_session->cancelPending();
+}
+
+void SerialConsole::write(const std::string& message) const
+{
+    auto request = std::make_unique<Request>();
+    request->kind = Request::Kind::Write;
+    request->messages.push_back(message);
+    execute(std::move(request));
 }
 
 } // namespace rtsd
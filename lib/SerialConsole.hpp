@@ -1,26 +1,75 @@
 #pragma once
+#include "types/Transaction.hpp"
+#include <fesd/Async.hpp>
+#include <fesd/Cancellation.hpp>
+#include <fesd/Deadline.hpp>
+#include <chrono>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace fesd {
 
+// Console protocol on a port: CR terminated commands, responses framed by the ">" prompt.
+// All I/O runs on the port's reactor thread, callers hand requests over through a lock-free queue.
 class SerialConsole final
 {
 public:
-    SerialConsole(std::string device);
+    struct Request
+    {
+        enum class Kind
+        {
+            Transact,
+            Write,
+            Connect,
+            Probe, // Reopens the port and transacts while disconnected, the port is closed again if it fails
+            Disconnect,
+            Shutdown,
+            Reject,  // Requests held for a recovery fail from now on, the recovery carries on
+            Release, // Ends a recovery, held requests go through again
+        };
+        // Called on the reactor thread, must not block or throw
+        using Completion = std::function<void(TransactionResults&& results, std::exception_ptr error)>;
+        using Written = std::function<void(std::chrono::steady_clock::time_point time)>;
+
+        Kind kind = Kind::Transact;
+        std::vector<std::string> messages;
+        std::size_t window = 1; // Commands kept in flight, responses are matched to commands in order
+        std::vector<std::chrono::milliseconds> timeouts; // Time each message's response may take, a 10s default when empty
+        Deadline deadline; // The whole request fails once this has passed
+        bool recovery = false; // Goes through while a recovery holds the other requests
+        CommandPriority priority = CommandPriority::Control;
+        std::optional<CancellationToken> cancellation; // Transfers fail with a CancellationError once it is cancelled
+        Completion completion;
+        Written written; // Once the first write of the request has gone to the port, optional
+    };
+    // Called on the reactor thread when an I/O error fails the port, must not block.
+    // Returning true closes the port and holds requests until a recovery releases them.
+    using LostHandler = std::function<bool(void)>;
+
+    SerialConsole(std::string device, LostHandler onLost = nullptr);
     ~SerialConsole();
-    std::string transact(const std::string& message) const;
+    // Queues the request and returns immediately, thread safe
+    void submit(std::unique_ptr<Request> request) const;
+    // Queues the request with a completion that fulfils the returned result
+    AsyncResult<TransactionResults> submitAsync(std::unique_ptr<Request> request) const;
+    // Queues the request and waits for it to complete, not allowed on an I/O thread
+    TransactionResults execute(std::unique_ptr<Request> request) const;
     void write(const std::string& message) const;
+    // Requests are held back while disconnected
     void disconnect(void) const;
     void reconnect(void) const;
+    // Time the last open of the port took until the device was ready, from opening it to its prompt
+    std::chrono::microseconds openLatency(void) const;
+    // Fails the queued transfers and abandons the one in flight with a CancellationError, returns straight away
+    void cancelPending(void) const;
 
 private:
-    void connect(void) const;
-    std::string read(void) const;
-
-private:
-    struct Device;
-    std::unique_ptr<Device> m_dev;
+    class Session;
+    std::shared_ptr<Session> m_session;
 };
 
 } // namespace rtsd
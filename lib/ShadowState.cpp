@@ -0,0 +1,242 @@
+#include "ShadowState.hpp"
+
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <charconv>
+#include <set>
+#include <utility>
+
+namespace {
+
+struct Setting
+{
+    std::vector<std::string_view> paths; // Paths the setting is read on, none when it is not addressed by path
+    bool kept; // The device takes the values as they are sent, other settings are clamped and read back
+};
+
+// Settings whose answers are shadowed, telemetry is always read from the device
+const std::map<std::string_view, Setting> ShadowedSettings = {
+    {"PATH:FREQ",        {{"RX", "TX"}, true }},
+    {"PATH:GAIN",        {{"RX", "TX"}, false}},
+    {"PATH:GAINLIM",     {{"RX", "TX"}, false}},
+    {"RFPATH:ATTN",      {{"TX"},       false}},
+    {"IFPATH:ATTN",      {{"RX"},       false}},
+    {"IFPATH:DCBIAS",    {{"RX", "TX"}, false}},
+    {"LOCLK:FREQ",       {{"RX", "TX"}, true }},
+    {"LOCLK:EN",         {{"RX", "TX"}, true }},
+    {"LOCLK:PHCUMU",     {{"RX", "TX"}, false}},
+    {"SYN:POW",          {{"RX", "TX"}, false}},
+    {"SYN:EN",           {{"RX", "TX"}, true }},
+    {"SYN:REFFREQ",      {{"RX", "TX"}, true }},
+    {"SYN:AUTOREF",      {{"RX", "TX"}, true }},
+    {"SYN:FFRAC",        {{"RX", "TX"}, true }},
+    {"SYN:RFSET",        {{"RX", "TX"}, false}},
+    {"RFPATH:PATH",      {{},           true }},
+    {"RFPATH:TDD",       {{},           true }},
+    {"REFPLL:CONFIG",    {{},           true }},
+    {"REFPLL:OUTPUT",    {{},           true }},
+    {"CONFIG:AUTOLOAD",  {{},           true }},
+    {"CONFIG:AUTOPHASE", {{},           true }},
+};
+
+struct Invalidation
+{
+    bool byPath; // Only the settings of the same path are dropped, otherwise the ones of every path
+    std::vector<std::string_view> settings;
+};
+
+// Settings the device derives from the one a command makes
+const std::map<std::string_view, Invalidation> DerivedSettings = {
+    {"PATH:FREQ",     {true,  {"PATH:GAINLIM", "PATH:GAIN", "LOCLK:FREQ", "LOCLK:PHCUMU", "SYN:RFSET"}}},
+    {"LOCLK:FREQ",    {true,  {"PATH:FREQ", "PATH:GAINLIM", "PATH:GAIN", "LOCLK:PHCUMU", "SYN:RFSET"}}},
+    {"LOCLK:PHINC",   {true,  {"LOCLK:PHCUMU"}}},
+    {"SYN:FFRAC",     {true,  {"SYN:RFSET"}}},
+    {"SYN:AUTOREF",   {true,  {"SYN:REFFREQ", "SYN:RFSET"}}},
+    {"SYN:REFFREQ",   {true,  {"SYN:RFSET"}}},
+    {"SYN:REFSRC",    {false, {"SYN:REFFREQ", "SYN:AUTOREF", "SYN:RFSET"}}},
+    {"REFPLL:CONFIG", {false, {"SYN:REFFREQ", "SYN:RFSET"}}},
+};
+
+// Commands that change nothing that is shadowed, any other command drops the whole shadow state of its slot
+const std::set<std::string_view> NeutralCommands = {
+    "CONFIG:APPLY",
+    "CONFIG:SAVE",
+    "REFDAC:DAC",
+    "SYS:ROLE",
+};
+
+std::vector<std::string> tokenize(std::string_view message)
+{
+    std::vector<std::string> tokens;
+    const std::string trimmed = boost::trim_copy(std::string(message));
+    if (!trimmed.empty())
+        boost::split(tokens, trimmed, boost::is_any_of(" "), boost::token_compress_on);
+    return tokens;
+}
+
+bool toSlotId(const std::string& text, uint16_t& slotId)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), slotId);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+bool isZero(const std::string& text)
+{
+    double value;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size() && value == 0.0;
+}
+
+thread_local bool refreshing = false;
+
+} // namespace
+
+namespace fesd {
+
+ShadowState::Refresh::Refresh()
+    : m_previous(std::exchange(refreshing, true))
+{
+}
+
+ShadowState::Refresh::~Refresh()
+{
+    refreshing = m_previous;
+}
+
+bool ShadowState::Refresh::active(void)
+{
+    return refreshing;
+}
+
+ShadowState::ShadowState(uint16_t slotId)
+    : m_slotId(slotId)
+{
+}
+
+std::vector<std::string> ShadowState::queries(void) const
+{
+    std::vector<std::string> messages;
+    const std::string slot = std::to_string(m_slotId);
+    for (const auto& [mnemonic, setting] : ShadowedSettings)
+    {
+        if (setting.paths.empty())
+            messages.push_back(std::string(mnemonic) + "? " + slot + " ");
+        for (const std::string_view path : setting.paths)
+            messages.push_back(std::string(mnemonic) + "? " + slot + " " + std::string(path) + " ");
+    }
+    return messages;
+}
+
+std::optional<std::string> ShadowState::lookup(const std::string& message) const
+{
+    const std::vector<std::string> tokens = tokenize(message);
+    uint16_t slotId;
+    if (tokens.size() < 2 || !tokens[0].ends_with('?') || !toSlotId(tokens[1], slotId) || slotId != m_slotId)
+        return std::nullopt;
+
+    const auto setting = ShadowedSettings.find(std::string_view(tokens[0]).substr(0, tokens[0].size() - 1));
+    if (setting == ShadowedSettings.end() || tokens.size() != (setting->second.paths.empty() ? 2 : 3))
+        return std::nullopt;
+
+    std::string key(setting->first);
+    if (tokens.size() > 2)
+        key += " " + tokens[2];
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    const auto answer = m_answers.find(key);
+    if (answer == m_answers.end())
+        return std::nullopt;
+    return answer->second;
+}
+
+void ShadowState::record(const std::vector<std::string>& messages, const TransactionResults& results)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    for (std::size_t i = 0; i < messages.size(); i++)
+        apply(tokenize(messages[i]), (i < results.size()) ? &results[i] : nullptr);
+}
+
+void ShadowState::clear(void)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_answers.clear();
+}
+
+void ShadowState::apply(const std::vector<std::string>& tokens, const TransactionResult* result)
+{
+    uint16_t slotId;
+    if (tokens.size() < 2 || !toSlotId(tokens[1], slotId))
+        return;
+
+    // A reset reboots every device on the port
+    if (tokens[0] == "*RST")
+    {
+        m_answers.clear();
+        return;
+    }
+    if (slotId != m_slotId)
+        return;
+
+    const bool success = (result != nullptr) && result->success;
+    const std::string_view mnemonic = std::string_view(tokens[0]).substr(0, tokens[0].find('?'));
+    const auto setting = ShadowedSettings.find(mnemonic);
+
+    if (tokens[0].ends_with('?'))
+    {
+        // Queries change nothing, the answers of shadowed settings are kept
+        if (success && setting != ShadowedSettings.end() && tokens.size() == (setting->second.paths.empty() ? 2 : 3))
+            m_answers[std::string(mnemonic) + (tokens.size() > 2 ? " " + tokens[2] : "")] = result->response;
+        return;
+    }
+
+    const auto derived = DerivedSettings.find(mnemonic);
+    if (setting == ShadowedSettings.end() && derived == DerivedSettings.end())
+    {
+        if (NeutralCommands.count(mnemonic) == 0)
+            m_answers.clear();
+        return;
+    }
+
+    const bool byPath = (setting != ShadowedSettings.end()) ? !setting->second.paths.empty() : derived->second.byPath;
+    const std::size_t addressSize = byPath ? 3 : 2;
+    if (tokens.size() < addressSize)
+    {
+        m_answers.clear();
+        return;
+    }
+    const std::string path = byPath ? tokens[2] : "";
+
+    if (derived != DerivedSettings.end())
+    {
+        for (const std::string_view other : derived->second.settings)
+            invalidate(other, path);
+    }
+    if (setting == ShadowedSettings.end())
+        return;
+
+    // The value the device derives from a frequency sent as 0 is only known once it is read back
+    const std::vector<std::string> values(tokens.begin() + addressSize, tokens.end());
+    const bool derivesValue = (mnemonic == "PATH:FREQ") && std::any_of(values.begin(), values.end(), isZero);
+    std::string key(mnemonic);
+    if (byPath)
+        key += " " + path;
+
+    if (success && setting->second.kept && !values.empty() && !derivesValue)
+        m_answers[key] = boost::join(values, " ");
+    else
+        m_answers.erase(key);
+}
+
+void ShadowState::invalidate(std::string_view mnemonic, const std::string& path)
+{
+    if (!path.empty())
+    {
+        m_answers.erase(std::string(mnemonic) + " " + path);
+        return;
+    }
+
+    const std::string prefix = std::string(mnemonic) + " ";
+    std::erase_if(m_answers, [&](const auto& item) { return item.first == mnemonic || item.first.starts_with(prefix); });
+}
+
+} // namespace fesd
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "types/Transaction.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fesd {
+
+// Last known answer to each setting query of a device, kept from the device's answers and from the settings it accepted.
+// A setting that may have changed some other way is dropped and read from the device again.
+class ShadowState final
+{
+public:
+    // Queries made by this thread while the scope is alive go to the device, their answers still update the shadow state.
+    // Used for readbacks, which confirm what the device has rather than what was last sent.
+    class Refresh final
+    {
+    public:
+        Refresh();
+        ~Refresh();
+        Refresh(const Refresh&) = delete;
+        Refresh& operator=(const Refresh&) = delete;
+
+        static bool active(void);
+
+    private:
+        bool m_previous;
+    };
+
+    explicit ShadowState(uint16_t slotId);
+
+    // Queries that read every setting that is shadowed
+    std::vector<std::string> queries(void) const;
+    // Answer to the query when the shadow state holds it, none for other messages and slots
+    std::optional<std::string> lookup(const std::string& message) const;
+    // Keeps the answers and settings of the device and applies the invalidation rules, messages for other slots are ignored.
+    // A message without a result is taken as failed, the setting it makes is then unknown.
+    void record(const std::vector<std::string>& messages, const TransactionResults& results);
+    void clear(void);
+
+private:
+    void apply(const std::vector<std::string>& tokens, const TransactionResult* result);
+    void invalidate(std::string_view mnemonic, const std::string& path);
+
+private:
+    const uint16_t m_slotId;
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::string> m_answers; // By setting and path, e.g. "PATH:GAIN RX"
+};
+
+} // namespace fesd
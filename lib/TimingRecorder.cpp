@@ -0,0 +1,96 @@
+#include "TimingRecorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Settle times of the SC2470 are a few milliseconds, the range covers the default retune timeout
+constexpr std::chrono::microseconds SettleBinWidth(100);
+constexpr std::size_t SettleBins = 500;
+
+} // namespace
+
+namespace fesd {
+
+TimingRecorder::TimingRecorder(std::chrono::nanoseconds binWidth, std::size_t bins)
+    : m_binWidth(std::max(binWidth, std::chrono::nanoseconds(1))),
+    m_counts(std::max<std::size_t>(bins, 1), 0)
+{
+}
+
+void TimingRecorder::add(std::chrono::nanoseconds time)
+{
+    const int64_t bin = std::max<int64_t>(time.count(), 0) / m_binWidth.count();
+    m_counts[std::min<std::size_t>(static_cast<std::size_t>(bin), m_counts.size() - 1)]++;
+    m_min = (m_samples == 0) ? time : std::min(m_min, time);
+    m_max = (m_samples == 0) ? time : std::max(m_max, time);
+    m_total += time;
+    m_samples++;
+}
+
+void TimingRecorder::reset(void)
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_samples = 0;
+    m_total = m_min = m_max = std::chrono::nanoseconds::zero();
+}
+
+std::chrono::nanoseconds TimingRecorder::quantile(double fraction) const
+{
+    if (m_samples == 0)
+        return std::chrono::nanoseconds::zero();
+    const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * m_samples)), 1);
+    uint64_t counted = 0;
+    for (std::size_t bin = 0; bin < m_counts.size(); bin++)
+    {
+        counted += m_counts[bin];
+        if (counted >= rank)
+            return std::min(m_binWidth * static_cast<int64_t>(bin + 1), m_max);
+    }
+    return m_max;
+}
+
+TimingHistogram TimingRecorder::snapshot(void) const
+{
+    const std::chrono::nanoseconds mean = (m_samples == 0) ? std::chrono::nanoseconds::zero() : m_total / static_cast<int64_t>(m_samples);
+    return {m_binWidth, m_counts, m_samples, m_min, m_max, mean};
+}
+
+SettleStatistics::SettleStatistics()
+    : m_times(SettleBinWidth, SettleBins)
+{
+}
+
+void SettleStatistics::record(std::chrono::nanoseconds settled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_times.add(settled);
+}
+
+void SettleStatistics::recordTimeout(void)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timeouts++;
+}
+
+std::chrono::nanoseconds SettleStatistics::median(void) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_times.quantile(0.5);
+}
+
+SettleStats SettleStatistics::get(void) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return {m_timeouts, m_times.snapshot(), m_times.quantile(0.5), m_times.quantile(0.9), m_times.quantile(0.99)};
+}
+
+void SettleStatistics::reset(void)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_times.reset();
+    m_timeouts = 0;
+}
+
+} // namespace fesd
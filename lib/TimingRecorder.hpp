@@ -0,0 +1,53 @@
+#pragma once
+
+#include <fesd/types/Common.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace fesd {
+
+// Histogram of measured times, not to be used by several threads at once
+class TimingRecorder final
+{
+public:
+    TimingRecorder(std::chrono::nanoseconds binWidth, std::size_t bins);
+
+    // Early times count in the first bin, late ones beyond the range in the last
+    void add(std::chrono::nanoseconds time);
+    void reset(void);
+    // Upper edge of the bin the fraction of the samples falls in, at most the longest time seen
+    std::chrono::nanoseconds quantile(double fraction) const;
+    TimingHistogram snapshot(void) const;
+
+private:
+    const std::chrono::nanoseconds m_binWidth;
+    std::vector<uint64_t> m_counts;
+    uint64_t m_samples = 0;
+    std::chrono::nanoseconds m_total{0};
+    std::chrono::nanoseconds m_min{0};
+    std::chrono::nanoseconds m_max{0};
+};
+
+// Times a device took to lock, shared by the commanders of the device
+class SettleStatistics final
+{
+public:
+    SettleStatistics();
+
+    void record(std::chrono::nanoseconds settled);
+    void recordTimeout(void);
+    std::chrono::nanoseconds median(void) const;
+    SettleStats get(void) const;
+    void reset(void);
+
+private:
+    mutable std::mutex m_mutex;
+    TimingRecorder m_times;
+    uint64_t m_timeouts = 0;
+};
+
+} // namespace fesd
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <limits>
+#include <stdexcept>
+#include <utility>
 
 namespace fesd 
 {
@@ -11,6 +15,22 @@ namespace utility
 bool isAlmostEqual(const double a, const double b, const double epsilon=std::numeric_limits<double>::epsilon());
 bool isAlmostEqualToZero(const double a, const double epsilon);
 
+// Compile-time lookup table, a std::map without the static construction and heap nodes
+template <typename Key, typename Value, std::size_t Size>
+using Table = std::array<std::pair<Key, Value>, Size>;
+
+// Value of the key, throws std::out_of_range like std::map::at
+template <typename Key, typename Value, std::size_t Size>
+constexpr const Value& at(const Table<Key, Value, Size>& table, const Key& key)
+{
+    for (const auto& item : table)
+    {
+        if (item.first == key)
+            return item.second;
+    }
+    throw std::out_of_range("Key not in table");
+}
+
 } // namespace utility
 
 } // namespace fesd
\ No newline at end of file
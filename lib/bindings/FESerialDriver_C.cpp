@@ -28,6 +28,11 @@
     {                                       \
         __VA_ARGS__                         \
     }                                       \
+    catch (fesd::CancellationError& e)      \
+    {                                       \
+        (void)e;/*handle compiler warning*/ \
+        return FESD_CODES_CANCELLED;        \
+    }                                       \
     catch (fesd::CommunicationError& e)     \
     {                                       \
         (void)e;/*handle compiler warning*/ \
@@ -201,6 +206,92 @@ FESD_API int16_t FESD_InitializeSC2470Commander(SessionRef_t session, uint32_t s
     return FESD_CODES_INVALID_ARGS;
 }
 
+FESD_API int16_t FESD_SetPipelineDepth(SessionRef_t session, uint16_t depth)
+{
+    for (Session& s : sessions)
+    {
+        if (s.feSerialDriver.get() == session)
+        {
+            FESD_C_CATCH_AND_RETURN
+            (
+                s.feSerialDriver->setPipelineDepth(depth);
+            )
+        }
+    }
+    return FESD_CODES_INVALID_ARGS;
+}
+
+FESD_API int16_t FESD_SetCommandTimeouts(SessionRef_t session, uint32_t fastMs, uint32_t retuneMs, uint32_t nvmMs, uint32_t rebootMs)
+{
+    fesd::CommandTimeouts timeouts;
+    timeouts.fast = std::chrono::milliseconds(fastMs);
+    timeouts.retune = std::chrono::milliseconds(retuneMs);
+    timeouts.nvm = std::chrono::milliseconds(nvmMs);
+    timeouts.reboot = std::chrono::milliseconds(rebootMs);
+
+    for (Session& s : sessions)
+    {
+        if (s.feSerialDriver.get() == session)
+        {
+            FESD_C_CATCH_AND_RETURN
+            (
+                s.feSerialDriver->setCommandTimeouts(timeouts);
+            )
+        }
+    }
+    return FESD_CODES_INVALID_ARGS;
+}
+
+FESD_API int16_t FESD_SetAutoRecovery(SessionRef_t session, bool enable, uint32_t timeoutMs)
+{
+    fesd::RecoverySettings settings;
+    settings.enabled = enable;
+    settings.timeout = std::chrono::milliseconds(timeoutMs);
+
+    for (Session& s : sessions)
+    {
+        if (s.feSerialDriver.get() == session)
+        {
+            FESD_C_CATCH_AND_RETURN
+            (
+                s.feSerialDriver->setAutoRecovery(settings);
+            )
+        }
+    }
+    return FESD_CODES_INVALID_ARGS;
+}
+
+FESD_API int16_t FESD_SetShadowState(SessionRef_t session, bool enable)
+{
+    for (Session& s : sessions)
+    {
+        if (s.feSerialDriver.get() == session)
+        {
+            FESD_C_CATCH_AND_RETURN
+            (
+                s.feSerialDriver->setShadowState(enable);
+            )
+        }
+    }
+    return FESD_CODES_INVALID_ARGS;
+}
+
+FESD_API int16_t FESD_ConfigureIoThreads(uint16_t threads, const int16_t* cpus, uint16_t cpuCount, int16_t realtimePriority)
+{
+    if (cpuCount > 0)
+        CheckReference(cpus);
+
+    fesd::IoThreadSettings settings;
+    settings.threads = threads;
+    settings.cpus.assign(cpus, cpus + cpuCount);
+    settings.realtimePriority = realtimePriority;
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        fesd::FESerialDriver::configureIoThreads(settings);
+    )
+}
+
 FESD_API int16_t FESD_GetId(DeviceRef_t device, uint16_t* id)
 {
     fesd::BaseCommander* baseDevice;
@@ -223,6 +314,41 @@ FESD_API int16_t FESD_ResetDevice(DeviceRef_t device)
     )
 }
 
+FESD_API int16_t FESD_ResetDeviceTimed(DeviceRef_t device, uint32_t* readyMs)
+{
+    fesd::BaseCommander* baseDevice;
+    GetBaseCommander(device, baseDevice)
+    CheckReference(readyMs);
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        *readyMs = static_cast<uint32_t>(baseDevice->resetDevice().count());
+    )
+}
+
+FESD_API int16_t FESD_CancelPending(DeviceRef_t device)
+{
+    fesd::BaseCommander* baseDevice;
+    GetBaseCommander(device, baseDevice)
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        baseDevice->cancelPending();
+    )
+}
+
+FESD_API int16_t FESD_GetPortOpenLatency(DeviceRef_t device, uint32_t* latencyUs)
+{
+    fesd::BaseCommander* baseDevice;
+    GetBaseCommander(device, baseDevice)
+    CheckReference(latencyUs);
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        *latencyUs = static_cast<uint32_t>(baseDevice->getPortOpenLatency().count());
+    )
+}
+
 FESD_API int16_t FESD_GetSerialNumber(DeviceRef_t device, char* serialNumber, uint16_t* size)
 {
     fesd::BaseCommander* baseDevice;
@@ -257,6 +383,28 @@ FESD_API int16_t FESD_GetSystemRole(DeviceRef_t device, FESD_SystemRole_t* syste
 }
 
 
+FESD_API int16_t FESD_SC2470SetReadbackPolicy(DeviceRef_t device, FESD_SC2470ReadbackPolicy_t policy)
+{
+    fesd::SC2470Commander* sc2470Device;
+    GetSC2470Commander(device, sc2470Device)
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        sc2470Device->setReadbackPolicy(static_cast<fesd::SC2470::ReadbackPolicy>(policy));
+    )
+}
+
+FESD_API int16_t FESD_SC2470VerifyReadbacks(DeviceRef_t device)
+{
+    fesd::SC2470Commander* sc2470Device;
+    GetSC2470Commander(device, sc2470Device)
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        sc2470Device->verifyReadbacks();
+    )
+}
+
 FESD_API int16_t FESD_SC2470ConfigureGain(DeviceRef_t device, FESD_Path_t path, double* gain)
 {
     fesd::SC2470Commander* sc2470Device;
@@ -619,4 +767,28 @@ FESD_API int16_t FESD_SC2470GetLoEnable(DeviceRef_t device, FESD_Path_t path, bo
     )
 }
 
+FESD_API int16_t FESD_SC2470GetPaTemperature(DeviceRef_t device, double* temperature)
+{
+    fesd::SC2470Commander* sc2470Device;
+    GetSC2470Commander(device, sc2470Device)
+    CheckReference(temperature);
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        *temperature = sc2470Device->getPaTemperature();
+    )
+}
+
+FESD_API int16_t FESD_SC2470GetReferenceLockDetect(DeviceRef_t device, double* lockDetect)
+{
+    fesd::SC2470Commander* sc2470Device;
+    GetSC2470Commander(device, sc2470Device)
+    CheckReference(lockDetect);
+
+    FESD_C_CATCH_AND_RETURN
+    (
+        *lockDetect = sc2470Device->getReferenceLockDetect();
+    )
+}
+
 
@@ -1,4 +1,6 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/chrono.h>
+#include <pybind11/functional.h>
 #include <pybind11/stl.h>
 #include <fesd/fesd.hpp>
 #include "Utility.hpp"
@@ -46,6 +48,66 @@ PYBIND11_MODULE(pyfesd, module) {
         .value("Integer", fesd::SC2470::SynthesizerMode::Integer)
         .value("Fractional", fesd::SC2470::SynthesizerMode::Fractional);
 
+    py::enum_<fesd::SC2470::ReadbackPolicy>(module, "SC2470ReadbackPolicy")
+        .value("Always", fesd::SC2470::ReadbackPolicy::Always)
+        .value("Never", fesd::SC2470::ReadbackPolicy::Never)
+        .value("Deferred", fesd::SC2470::ReadbackPolicy::Deferred);
+
+    py::class_<fesd::IoThreadSettings>(module, "IoThreadSettings")
+        .def(py::init<>())
+        .def_readwrite("threads", &fesd::IoThreadSettings::threads)
+        .def_readwrite("cpus", &fesd::IoThreadSettings::cpus)
+        .def_readwrite("realtimePriority", &fesd::IoThreadSettings::realtimePriority);
+
+    py::class_<fesd::SchedulerSettings>(module, "SchedulerSettings")
+        .def(py::init<>())
+        .def_readwrite("cpu", &fesd::SchedulerSettings::cpu)
+        .def_readwrite("realtimePriority", &fesd::SchedulerSettings::realtimePriority)
+        .def_readwrite("spin", &fesd::SchedulerSettings::spin)
+        .def_readwrite("binWidth", &fesd::SchedulerSettings::binWidth)
+        .def_readwrite("bins", &fesd::SchedulerSettings::bins);
+
+    py::class_<fesd::TimingHistogram>(module, "TimingHistogram")
+        .def_readonly("binWidth", &fesd::TimingHistogram::binWidth)
+        .def_readonly("counts", &fesd::TimingHistogram::counts)
+        .def_readonly("samples", &fesd::TimingHistogram::samples)
+        .def_readonly("min", &fesd::TimingHistogram::min)
+        .def_readonly("max", &fesd::TimingHistogram::max)
+        .def_readonly("mean", &fesd::TimingHistogram::mean);
+
+    py::class_<fesd::ScheduleStats>(module, "ScheduleStats")
+        .def_readonly("sent", &fesd::ScheduleStats::sent)
+        .def_readonly("failed", &fesd::ScheduleStats::failed)
+        .def_readonly("dispatchJitter", &fesd::ScheduleStats::dispatchJitter)
+        .def_readonly("completionLatency", &fesd::ScheduleStats::completionLatency);
+
+    py::class_<fesd::SettleStats>(module, "SettleStats")
+        .def_readonly("timeouts", &fesd::SettleStats::timeouts)
+        .def_readonly("settleTime", &fesd::SettleStats::settleTime)
+        .def_readonly("p50", &fesd::SettleStats::p50)
+        .def_readonly("p90", &fesd::SettleStats::p90)
+        .def_readonly("p99", &fesd::SettleStats::p99);
+
+    // Due times are given as the time since the steady clock's epoch, which is time.monotonic_ns() on Linux
+    py::class_<fesd::CommandScheduler>(module, "CommandScheduler")
+        .def(py::init<const fesd::SchedulerSettings&>(), "settings"_a = fesd::SchedulerSettings())
+        .def("cancelPending", &fesd::CommandScheduler::cancelPending)
+        .def("waitIdle", &fesd::CommandScheduler::waitIdle)
+        .def("getStats", &fesd::CommandScheduler::getStats)
+        .def("resetStats", &fesd::CommandScheduler::resetStats);
+
+    py::class_<fesd::CommandTimeouts>(module, "CommandTimeouts")
+        .def(py::init<>())
+        .def_readwrite("fast", &fesd::CommandTimeouts::fast)
+        .def_readwrite("retune", &fesd::CommandTimeouts::retune)
+        .def_readwrite("nvm", &fesd::CommandTimeouts::nvm)
+        .def_readwrite("reboot", &fesd::CommandTimeouts::reboot);
+
+    py::class_<fesd::RecoverySettings>(module, "RecoverySettings")
+        .def(py::init<>())
+        .def_readwrite("enabled", &fesd::RecoverySettings::enabled)
+        .def_readwrite("timeout", &fesd::RecoverySettings::timeout);
+
     py::class_<fesd::FEDevice>(module, "FEDevice")
         .def_readonly("slotId", &fesd::FEDevice::slotId)
         .def_readonly("type", &fesd::FEDevice::type)
@@ -83,15 +145,80 @@ PYBIND11_MODULE(pyfesd, module) {
         .def(py::init<double, double>(), "minDb"_a, "maxDb"_a)
         .def_readonly("minDb", &fesd::SC2470::GainLimitsSet::minDb)
         .def_readonly("maxDb", &fesd::SC2470::GainLimitsSet::maxDb);
+
+    py::class_<fesd::SC2470::PathConfiguration>(module, "SC2470PathConfiguration")
+        .def(py::init<>())
+        .def_readwrite("frequencies", &fesd::SC2470::PathConfiguration::frequencies)
+        .def_readwrite("gainDb", &fesd::SC2470::PathConfiguration::gainDb)
+        .def_readwrite("attenuationDb", &fesd::SC2470::PathConfiguration::attenuationDb)
+        .def_readwrite("synthesizer", &fesd::SC2470::PathConfiguration::synthesizer)
+        .def_readwrite("loEnable", &fesd::SC2470::PathConfiguration::loEnable)
+        .def_readwrite("internalReference", &fesd::SC2470::PathConfiguration::internalReference)
+        .def_readwrite("phaseOffset", &fesd::SC2470::PathConfiguration::phaseOffset)
+        .def_readwrite("dcBias", &fesd::SC2470::PathConfiguration::dcBias);
+
+    py::class_<fesd::SC2470::Configuration>(module, "SC2470Configuration")
+        .def(py::init<>())
+        .def_readwrite("referenceSource", &fesd::SC2470::Configuration::referenceSource)
+        .def_readwrite("referenceOutputEnable", &fesd::SC2470::Configuration::referenceOutputEnable)
+        .def_readwrite("duplex", &fesd::SC2470::Configuration::duplex)
+        .def_readwrite("rx", &fesd::SC2470::Configuration::rx)
+        .def_readwrite("tx", &fesd::SC2470::Configuration::tx);
     
+    py::class_<fesd::SC2470::Hop>(module, "SC2470Hop")
+        .def(py::init<fesd::SC2470::Path, fesd::SC2470::FrequencySet, std::chrono::microseconds>(), "path"_a, "frequencies"_a, "dwell"_a)
+        .def_readwrite("path", &fesd::SC2470::Hop::path)
+        .def_readwrite("frequencies", &fesd::SC2470::Hop::frequencies)
+        .def_readwrite("dwell", &fesd::SC2470::Hop::dwell);
+
+    py::class_<fesd::SC2470::ReferenceSwitch>(module, "SC2470ReferenceSwitch")
+        .def_readonly("source", &fesd::SC2470::ReferenceSwitch::source)
+        .def_readonly("timeToLock", &fesd::SC2470::ReferenceSwitch::timeToLock);
+
+    py::class_<fesd::SC2470::SweepReport>(module, "SC2470SweepReport")
+        .def_readonly("hops", &fesd::SC2470::SweepReport::hops)
+        .def_readonly("elapsed", &fesd::SC2470::SweepReport::elapsed)
+        .def_readonly("hopsPerSecond", &fesd::SC2470::SweepReport::hopsPerSecond)
+        .def_readonly("latencyP50", &fesd::SC2470::SweepReport::latencyP50)
+        .def_readonly("latencyP90", &fesd::SC2470::SweepReport::latencyP90)
+        .def_readonly("latencyP99", &fesd::SC2470::SweepReport::latencyP99)
+        .def_readonly("latencyMax", &fesd::SC2470::SweepReport::latencyMax);
+
+    py::class_<fesd::SC2470Sweep>(module, "SC2470Sweep")
+        .def_static("readCsv", &fesd::SC2470Sweep::readCsv, "path"_a)
+        .def_static("readBinary", &fesd::SC2470Sweep::readBinary, "path"_a)
+        .def_static("writeBinary", [](const std::string& path, const std::vector<fesd::SC2470::Hop>& hops) { fesd::SC2470Sweep::writeBinary(path, hops); }, "path"_a, "hops"_a)
+        .def("setHopCallback", &fesd::SC2470Sweep::setHopCallback, "callback"_a)
+        .def("size", &fesd::SC2470Sweep::size)
+        .def("run", &fesd::SC2470Sweep::run);
+
+    py::class_<fesd::SC2470PreparedSetting>(module, "SC2470PreparedSetting")
+        .def("set", &fesd::SC2470PreparedSetting::set, "value"_a);
+
     py::class_<fesd::SC2470Commander>(module, "SC2470Commander")
         .def("resetDevice", &fesd::SC2470Commander::resetDevice)
+        .def("cancelPending", &fesd::SC2470Commander::cancelPending)
+        .def("getPortOpenLatency", &fesd::SC2470Commander::getPortOpenLatency)
         .def("getId", &fesd::SC2470Commander::getSlotId)
         .def("getDeviceType", &fesd::SC2470Commander::getDeviceType)
         .def("getSystemRole", &fesd::SC2470Commander::getSystemRole)
         .def("getFirmwareVersion", &fesd::SC2470Commander::getFirmwareVersion)
         .def("getSystemRole", &fesd::SC2470Commander::getSystemRole)
         .def("getSerialNumber", &fesd::SC2470Commander::getSerialNumber)
+        .def("setReadbackPolicy", &fesd::SC2470Commander::setReadbackPolicy, "policy"_a)
+        .def("getReadbackPolicy", &fesd::SC2470Commander::getReadbackPolicy)
+        .def("verifyReadbacks", &fesd::SC2470Commander::verifyReadbacks)
+        .def("configure", &fesd::SC2470Commander::configure, "config"_a)
+        .def("stage", &fesd::SC2470Commander::stage, "config"_a)
+        .def("applyStaged", &fesd::SC2470Commander::applyStaged)
+        .def("discardStaged", &fesd::SC2470Commander::discardStaged)
+        .def("getStaged", &fesd::SC2470Commander::getStaged)
+        .def("prepareGain", &fesd::SC2470Commander::prepareGain, "path"_a)
+        .def("preparePhaseIncrement", &fesd::SC2470Commander::preparePhaseIncrement, "path"_a)
+        .def("scheduleFrequencies", [](const fesd::SC2470Commander& commander, fesd::CommandScheduler& scheduler, std::chrono::nanoseconds at, fesd::SC2470::Path path, fesd::SC2470::FrequencySet freqs) { commander.scheduleFrequencies(scheduler, std::chrono::steady_clock::time_point(at), path, freqs); }, "scheduler"_a, "at"_a, "path"_a, "freqs"_a)
+        .def("scheduleGain", [](const fesd::SC2470Commander& commander, fesd::CommandScheduler& scheduler, std::chrono::nanoseconds at, fesd::SC2470::Path path, double gainDb) { commander.scheduleGain(scheduler, std::chrono::steady_clock::time_point(at), path, gainDb); }, "scheduler"_a, "at"_a, "path"_a, "gainDb"_a)
+        .def("scheduleDuplexSetting", [](const fesd::SC2470Commander& commander, fesd::CommandScheduler& scheduler, std::chrono::nanoseconds at, fesd::SC2470::DuplexSetting setting) { commander.scheduleDuplexSetting(scheduler, std::chrono::steady_clock::time_point(at), setting); }, "scheduler"_a, "at"_a, "setting"_a)
+        .def("compileSweep", [](const fesd::SC2470Commander& commander, const std::vector<fesd::SC2470::Hop>& hops) { return commander.compileSweep(hops); }, "hops"_a)
         .def("getGainLimits", &fesd::SC2470Commander::getGainLimits, "path"_a)
         .def("getGain", &fesd::SC2470Commander::getGain, "path"_a)
         .def("configureGain", &fesd::SC2470Commander::configureGain, "path"_a, "gainDb"_a)
@@ -114,6 +241,7 @@ PYBIND11_MODULE(pyfesd, module) {
         .def("configureDuplexSetting", &fesd::SC2470Commander::configureDuplexSetting, "setting"_a) 
         .def("getReferenceSource", &fesd::SC2470Commander::getReferenceSource)        
         .def("configureReferenceSource", &fesd::SC2470Commander::configureReferenceSource, "source"_a)
+        .def("switchReferenceSource", &fesd::SC2470Commander::switchReferenceSource, "source"_a)
         .def("getInternalReferenceOverride", &fesd::SC2470Commander::getInternalReferenceOverride, "path"_a)        
         .def("configureInternalReferenceOverride", &fesd::SC2470Commander::configureInternalReferenceOverride, "path"_a, "freq"_a)
         .def("getPhaseOffset", &fesd::SC2470Commander::getPhaseOffset, "path"_a)
@@ -122,7 +250,13 @@ PYBIND11_MODULE(pyfesd, module) {
         .def("configureDCBias", &fesd::SC2470Commander::configureDCBias, "path"_a, "bias"_a)
         .def("getDCBias", &fesd::SC2470Commander::getDCBias, "path"_a)
         .def("configureReferenceOutputEnable", &fesd::SC2470Commander::configureReferenceOutputEnable, "enable"_a)
-        .def("getReferenceOutputEnable", &fesd::SC2470Commander::getReferenceOutputEnable);
+        .def("getReferenceOutputEnable", &fesd::SC2470Commander::getReferenceOutputEnable)
+        .def("getPaTemperature", &fesd::SC2470Commander::getPaTemperature)
+        .def("getReferenceLockDetect", &fesd::SC2470Commander::getReferenceLockDetect)
+        .def("waitForLock", &fesd::SC2470Commander::waitForLock, "timeout"_a)
+        .def("waitForSettled", &fesd::SC2470Commander::waitForSettled)
+        .def("getSettleStats", &fesd::SC2470Commander::getSettleStats)
+        .def("resetSettleStats", &fesd::SC2470Commander::resetSettleStats);
 
 
     py::class_<fesd::FESerialDriver>(module, "FESerialDriver")
@@ -131,5 +265,10 @@ PYBIND11_MODULE(pyfesd, module) {
         .def("getSC2470Commander", py::overload_cast<const std::string&>(&fesd::FESerialDriver::getSC2470Commander, py::const_), "serialNumber"_a)
         .def("getSC2470Commander", py::overload_cast<const uint16_t>(&fesd::FESerialDriver::getSC2470Commander, py::const_), "slotId"_a)
         .def("getSC2470Commander", py::overload_cast<const fesd::FEDevice&>(&fesd::FESerialDriver::getSC2470Commander, py::const_), "device"_a)
-        .def("getSC2470Commanders", &fesd::FESerialDriver::getSC2470Commanders);
+        .def("getSC2470Commanders", &fesd::FESerialDriver::getSC2470Commanders)
+        .def("setPipelineDepth", &fesd::FESerialDriver::setPipelineDepth, "depth"_a)
+        .def("setCommandTimeouts", &fesd::FESerialDriver::setCommandTimeouts, "timeouts"_a)
+        .def("setAutoRecovery", &fesd::FESerialDriver::setAutoRecovery, "settings"_a)
+        .def("setShadowState", &fesd::FESerialDriver::setShadowState, "enable"_a)
+        .def_static("configureIoThreads", &fesd::FESerialDriver::configureIoThreads, "settings"_a);
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "IoReactor.hpp"
+#include <fesd/types/Exception.hpp>
+
+#include <string>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace fesd {
+
+struct IoReactor::Worker
+{
+    boost::asio::io_context io{1};
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work = boost::asio::make_work_guard(io);
+    std::thread thread;
+};
+
+IoReactor& IoReactor::instance(void)
+{
+    // Never destroyed, ports may still complete I/O while static objects are torn down
+    static IoReactor* reactor = new IoReactor();
+    return *reactor;
+}
+
+boost::asio::io_context& IoReactor::nextContext(void)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    start(m_settings.threads);
+    Worker& worker = *m_workers[m_next++ % m_workers.size()];
+    return worker.io;
+}
+
+void IoReactor::configure(const IoThreadSettings& settings)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_settings = settings;
+    start(settings.threads);
+    for (std::size_t index = 0; index < m_workers.size(); index++)
+        applySettings(index);
+}
+
+void IoReactor::start(std::size_t threads)
+{
+    threads = std::max<std::size_t>(threads, 1);
+    while (m_workers.size() < threads)
+    {
+        auto worker = std::make_unique<Worker>();
+        boost::asio::io_context& io = worker->io;
+        worker->thread = std::thread(
+            [&io]()
+            {
+                io.run();
+            }
+        );
+        m_workers.push_back(std::move(worker));
+        applySettings(m_workers.size() - 1);
+    }
+}
+
+void IoReactor::applySettings(std::size_t index)
+{
+    const int cpu = m_settings.cpus.empty() ? -1 : m_settings.cpus[index % m_settings.cpus.size()];
+    if (!applyThreadSettings(m_workers[index]->thread, "fesd-io" + std::to_string(index), cpu, m_settings.realtimePriority))
+        throw InvalidArgumentsError("Could not apply I/O thread CPU pinning or priority");
+}
+
+bool applyThreadSettings(std::thread& thread, const std::string& name, int cpu, int realtimePriority)
+{
+    bool success = true;
+
+#if defined(__linux__)
+    pthread_setname_np(thread.native_handle(), name.c_str());
+
+    if (cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        success &= (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) == 0);
+    }
+
+    sched_param param{};
+    param.sched_priority = realtimePriority;
+    const int policy = (realtimePriority > 0) ? SCHED_FIFO : SCHED_OTHER;
+    success &= (pthread_setschedparam(thread.native_handle(), policy, &param) == 0);
+#elif defined(WIN32)
+    if (cpu >= 0)
+        success &= (SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << cpu) != 0);
+    success &= (SetThreadPriority(thread.native_handle(), (realtimePriority > 0) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_NORMAL) != 0);
+#endif
+
+    return success;
+}
+
+} // namespace fesd
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <fesd/types/Common.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef WIN32
+#include "wintargetsys.h" // required for boost/asio on windows, include before boost/asio
+#endif // WIN32
+#include <boost/asio.hpp>
+
+namespace fesd {
+
+// Names the thread, pins it to the CPU unless that is negative and gives it real-time priority when above 0.
+// Returns false if pinning or priority could not be applied.
+bool applyThreadSettings(std::thread& thread, const std::string& name, int cpu, int realtimePriority);
+
+// Driver wide event loop, a small pool of threads that each run one io_context for a share of the ports.
+// Started on first use and kept for the lifetime of the process.
+class IoReactor final
+{
+public:
+    static IoReactor& instance(void);
+
+    // Context for a new port, ports are assigned to the threads in turn
+    boost::asio::io_context& nextContext(void);
+    // Throws InvalidArgumentsError if pinning or priority could not be applied
+    void configure(const IoThreadSettings& settings);
+
+private:
+    IoReactor() = default;
+    void start(std::size_t threads);
+    void applySettings(std::size_t index);
+
+private:
+    struct Worker;
+    std::mutex m_mutex;
+    IoThreadSettings m_settings;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::size_t m_next = 0;
+};
+
+} // namespace fesd
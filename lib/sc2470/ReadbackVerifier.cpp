@@ -0,0 +1,47 @@
+#include "ReadbackVerifier.hpp"
+#include <fesd/types/Exception.hpp>
+
+namespace fesd
+{
+
+void ReadbackVerifier::check(void)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_failure)
+        report(lock);
+}
+
+void ReadbackVerifier::wait(void)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_pending == 0; });
+    if (m_failure)
+        report(lock);
+}
+
+void ReadbackVerifier::started(void)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_pending++;
+}
+
+void ReadbackVerifier::finished(std::optional<std::string> failure)
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_pending--;
+        if (failure && !m_failure)
+            m_failure = std::move(failure);
+    }
+    m_idle.notify_all();
+}
+
+void ReadbackVerifier::report(std::unique_lock<std::mutex>& lock)
+{
+    // A failure is reported once
+    const std::string failure = std::exchange(m_failure, std::nullopt).value();
+    lock.unlock();
+    throw CommunicationError(failure);
+}
+
+} // namespace fesd
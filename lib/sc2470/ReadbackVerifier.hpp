@@ -0,0 +1,58 @@
+#pragma once
+
+#include <fesd/Async.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace fesd
+{
+
+// Readbacks of the Deferred policy, verified in the background. The first one that fails or does not match
+// what was set is kept until check() or wait() reports it.
+class ReadbackVerifier final
+{
+public:
+    // Compares the readback with the value set once it completes, the verifier is kept alive until then
+    template <typename T, typename Equal>
+    static AsyncResult<void> verify(std::shared_ptr<ReadbackVerifier> verifier, AsyncResult<T> readback, T expected, Equal equal, std::string setting)
+    {
+        verifier->started();
+
+        std::optional<std::string> failure;
+        try
+        {
+            if (!equal(co_await readback, expected))
+                failure = "Readback of " + setting + " does not match the setting...";
+        }
+        catch (const std::exception& error)
+        {
+            failure = "Readback of " + setting + " failed: " + error.what();
+        }
+        verifier->finished(std::move(failure));
+    }
+
+    // Throws the failure kept without waiting for the readbacks in flight
+    void check(void);
+    // Waits for the readbacks in flight, then throws the failure kept
+    void wait(void);
+
+private:
+    void started(void);
+    void finished(std::optional<std::string> failure);
+    [[noreturn]] void report(std::unique_lock<std::mutex>& lock);
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_idle;
+    std::size_t m_pending = 0;
+    std::optional<std::string> m_failure;
+};
+
+} // namespace fesd
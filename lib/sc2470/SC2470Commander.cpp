@@ -3,100 +3,104 @@
 #include "SC2470Processor.hpp"
 #include "GeneralProcessor.hpp"
 #include "DeviceConnection.hpp"
+#include "ReadbackVerifier.hpp"
+#include "ShadowState.hpp"
 #include "Utility.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
 
 namespace 
 {
 
-} // static namespace
-
-namespace fesd
+fesd::SC2470::DuplexSetting toDuplexSetting(const fesd::SC2470Processor::DuplexState& state)
 {
+    if (state.rfPath == fesd::SC2470Processor::DuplexSetting::FDD)
+        return fesd::SC2470::DuplexSetting::Fdd;
+    if (state.tddPath == fesd::SC2470::Path::TX)
+        return fesd::SC2470::DuplexSetting::TddTx;
+    return fesd::SC2470::DuplexSetting::TddRx;
+}
 
-SC2470Commander::SC2470Commander(std::shared_ptr<DeviceDetails> device)
-    : BaseCommander(device),
-    m_coProcessor(std::make_shared<SC2470Processor>(device))
+fesd::SC2470::InternalReferenceFrequency toInternalReferenceFrequency(const fesd::SC2470Processor::SynthesizerReferenceState& state)
 {
-    // Will throw an exception if invalid parameters are given
-    m_genProcessor->getId();
-};
+    if (state.automatic)
+        return fesd::SC2470::InternalReferenceFrequency::Automatic;
+    else if (state.freq == fesd::SC2470Processor::SynthsizerReferenceFreq::Freq100MHz)
+        return fesd::SC2470::InternalReferenceFrequency::Force100MHz;
+    return fesd::SC2470::InternalReferenceFrequency::Force105MHz;
+}
 
-SC2470::GainLimitsSet SC2470Commander::getGainLimits(SC2470::Path path) const
+fesd::SC2470::ReferenceSource toReferenceSource(const fesd::SC2470Processor::ReferenceConfig& config)
 {
-    SC2470Processor::GainLimitsSet procGainLimits = m_coProcessor->getGainLimits(path);
-    if (utility::isAlmostEqualToZero(procGainLimits.maxDb - procGainLimits.minDb, 0.001)) {
-        throw CalibrationError("Gain limits have zero range");
+    if (config.clkSource == fesd::SC2470Processor::ClockSource::Internal)
+        return fesd::SC2470::ReferenceSource::Internal;
+    else if (config.clkSource == fesd::SC2470Processor::ClockSource::External)
+    {
+        if (config.freqSel == fesd::SC2470Processor::ReferenceFreq::Freq10MHz)
+            return fesd::SC2470::ReferenceSource::External10MHz;
+        else if (config.freqSel == fesd::SC2470Processor::ReferenceFreq::Freq100MHz)
+            return fesd::SC2470::ReferenceSource::External100MHz;
     }
-    return {procGainLimits.minDb, procGainLimits.maxDb};
+
+    throw fesd::CommunicationError("Invalid response from device...");
 }
 
-double SC2470Commander::getGain(SC2470::Path path) const
+double clampLoFrequencyKHz(double frequencyKHz)
 {
-    return m_coProcessor->getGain(path);
+    if (frequencyKHz < (fesd::SC2470::LoFrequency::loMinHz / 1000.0))
+        return fesd::SC2470::LoFrequency::loMinHz / 1000.0;
+    if (frequencyKHz > (fesd::SC2470::LoFrequency::loMaxHz / 1000.0))
+        return fesd::SC2470::LoFrequency::loMaxHz / 1000.0;
+    return frequencyKHz;
 }
 
-double SC2470Commander::configureGain(SC2470::Path path, double gainDb) const
+fesd::SC2470::GainLimitsSet toGainLimits(const fesd::SC2470Processor::GainLimitsSet& limits)
 {
-    SC2470::GainLimitsSet gainLimits = getGainLimits(path);
-    if(gainDb > gainLimits.maxDb) {
-        gainDb = gainLimits.maxDb;
-    } else if (gainDb < gainLimits.minDb) {
-        gainDb = gainLimits.minDb;
+    if (fesd::utility::isAlmostEqualToZero(limits.maxDb - limits.minDb, 0.001)) {
+        throw fesd::CalibrationError("Gain limits have zero range");
     }
-    m_coProcessor->setGain(path, gainDb);
-    return this->getGain(path);
+    return {limits.minDb, limits.maxDb};
 }
 
-double SC2470Commander::getAttenuation(SC2470::Path path) const
-{    
-    if (path == SC2470::Path::TX)
-        return m_coProcessor->getAttnTx();
-    else
-    {
-        SC2470Processor::AttenuatorRxSet rxValues = m_coProcessor->getAttnRx();
-        return rxValues.attnADb + rxValues.attnBDb;
-    }
+double clampGain(double gainDb, const fesd::SC2470::GainLimitsSet& limits)
+{
+    if (gainDb > limits.maxDb)
+        return limits.maxDb;
+    if (gainDb < limits.minDb)
+        return limits.minDb;
+    return gainDb;
 }
 
-double SC2470Commander::configureAttenuation(SC2470::Path path, double attenuationDb) const
+double clampAttenuation(fesd::SC2470::Path path, double attenuationDb)
 {
-    if (path == SC2470::Path::TX)
-    {
-        if (attenuationDb < 0)
-            attenuationDb = 0;
-        if (attenuationDb > 31.5)
-            attenuationDb = 31.5;
-
-        m_coProcessor->setAttnTx(attenuationDb);
-        return this->getAttenuation(path);
-    }
-    else
-    {
-        if (attenuationDb < 0)
-            attenuationDb = 0;
-        if (attenuationDb > 63.25)
-            attenuationDb = 63.25;
+    const double maxDb = (path == fesd::SC2470::Path::TX) ? 31.5 : 63.25;
+    if (attenuationDb < 0)
+        return 0;
+    if (attenuationDb > maxDb)
+        return maxDb;
+    return attenuationDb;
+}
 
-        // Apply roughly equally accross attns
-        // AttnA will lead in upticks
-        SC2470Processor::AttenuatorRxSet rxValues;
+fesd::SC2470Processor::AttenuatorRxSet splitRxAttenuation(double attenuationDb)
+{
+    // Apply roughly equally accross attns
+    // AttnA will lead in upticks
+    fesd::SC2470Processor::AttenuatorRxSet rxValues;
 
-        rxValues.attnBDb = 0.5 * round(attenuationDb);
-        rxValues.attnADb = attenuationDb - rxValues.attnBDb;
+    rxValues.attnBDb = 0.5 * round(attenuationDb);
+    rxValues.attnADb = attenuationDb - rxValues.attnBDb;
 
-        m_coProcessor->setAttnRx(rxValues);
-        return this->getAttenuation(path);
-    }
+    return rxValues;
 }
 
-SC2470::FrequencySet SC2470Commander::getFrequencies(SC2470::Path path) const
+fesd::SC2470::FrequencySet toFrequencySetHz(const fesd::SC2470Processor::FrequencySet& freqsKHz)
 {
-    SC2470::FrequencySet freqsHz;
-    SC2470Processor::FrequencySet freqsKHz;
-
-    freqsKHz = m_coProcessor->getFrequencies(path);
+    fesd::SC2470::FrequencySet freqsHz;
 
     freqsHz.rfHz = freqsKHz.rfKHz * 1000;
     freqsHz.ifHz = freqsKHz.ifKHz * 1000;
@@ -105,43 +109,45 @@ SC2470::FrequencySet SC2470Commander::getFrequencies(SC2470::Path path) const
     return freqsHz;
 }
 
-SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::IfFrequency ifFreq) const
+fesd::SC2470Processor::FrequencySet toFrequencySetKHz(fesd::SC2470::RfFrequency rfFreq, fesd::SC2470::IfFrequency ifFreq)
 {
-    SC2470Processor::FrequencySet freqsKHz;
+    using fesd::SC2470::LoFrequency;
+    fesd::SC2470Processor::FrequencySet freqsKHz;
 
     freqsKHz.loKHz = 0.0;
-    if ((rfFreq.rfHz - ifFreq.ifHz) < SC2470::LoFrequency::loMinHz) {
-        freqsKHz.rfKHz = (ifFreq.ifHz + SC2470::LoFrequency::loMinHz) / 1000.0;
+    if ((rfFreq.rfHz - ifFreq.ifHz) < LoFrequency::loMinHz) {
+        freqsKHz.rfKHz = (ifFreq.ifHz + LoFrequency::loMinHz) / 1000.0;
     } else {
         freqsKHz.rfKHz = rfFreq.rfHz / 1000.0;
     }
     freqsKHz.ifKHz = ifFreq.ifHz / 1000.0;
-    m_coProcessor->setFrequencies(path, freqsKHz);
-    return this->getFrequencies(path);
+
+    return freqsKHz;
 }
 
-SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::LoFrequency loFreq) const
+fesd::SC2470Processor::FrequencySet toFrequencySetKHz(fesd::SC2470::RfFrequency rfFreq, fesd::SC2470::LoFrequency loFreq)
 {
-    SC2470::FrequencySet freqsHz;
-    SC2470Processor::FrequencySet freqsKHz;
+    using fesd::SC2470::IfFrequency;
+    using fesd::SC2470::LoFrequency;
+    fesd::SC2470Processor::FrequencySet freqsKHz;
 
     freqsKHz.ifKHz = 0.0;
 
-    if ((rfFreq.rfHz - loFreq.loHz) < SC2470::IfFrequency::ifMinHz)
+    if ((rfFreq.rfHz - loFreq.loHz) < IfFrequency::ifMinHz)
     {
-        if ((rfFreq.rfHz - SC2470::LoFrequency::loMinHz) > SC2470::IfFrequency::ifMinHz)
+        if ((rfFreq.rfHz - LoFrequency::loMinHz) > IfFrequency::ifMinHz)
         {
             freqsKHz.rfKHz = (rfFreq.rfHz / 1000.0);
-            freqsKHz.loKHz = (SC2470::LoFrequency::loMinHz / 1000.0);
+            freqsKHz.loKHz = (LoFrequency::loMinHz / 1000.0);
         }
         else 
         {
-            freqsKHz.rfKHz = ((SC2470::LoFrequency::loMinHz + SC2470::IfFrequency::ifMinHz) / 1000.0);
-            freqsKHz.loKHz = (SC2470::LoFrequency::loMinHz / 1000.0);
+            freqsKHz.rfKHz = ((LoFrequency::loMinHz + IfFrequency::ifMinHz) / 1000.0);
+            freqsKHz.loKHz = (LoFrequency::loMinHz / 1000.0);
         }
     }
-    else if ((rfFreq.rfHz - loFreq.loHz) > SC2470::IfFrequency::ifMaxHz) {
-        freqsKHz.rfKHz = (loFreq.loHz + SC2470::IfFrequency::ifMaxHz) / 1000.0;
+    else if ((rfFreq.rfHz - loFreq.loHz) > IfFrequency::ifMaxHz) {
+        freqsKHz.rfKHz = (loFreq.loHz + IfFrequency::ifMaxHz) / 1000.0;
         freqsKHz.loKHz = loFreq.loHz / 1000.0;
     }
     else
@@ -150,24 +156,23 @@ SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC
         freqsKHz.loKHz = loFreq.loHz / 1000.0;
     }
 
-    m_coProcessor->setFrequencies(path, freqsKHz);
-    return this->getFrequencies(path);
+    return freqsKHz;
 }
 
-SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::IfFrequency ifFreq, SC2470::LoFrequency loFreq) const
+fesd::SC2470Processor::FrequencySet toFrequencySetKHz(fesd::SC2470::IfFrequency ifFreq, fesd::SC2470::LoFrequency loFreq)
 {
-    SC2470::FrequencySet freqsHz;
-    SC2470Processor::FrequencySet freqsKHz;
+    using fesd::SC2470::RfFrequency;
+    fesd::SC2470Processor::FrequencySet freqsKHz;
 
     freqsKHz.rfKHz = 0.0;
 
-    if ((loFreq.loHz + ifFreq.ifHz) < SC2470::RfFrequency::rfMinHz)
+    if ((loFreq.loHz + ifFreq.ifHz) < RfFrequency::rfMinHz)
     {
-        freqsKHz.loKHz = (ifFreq.ifHz + SC2470::RfFrequency::rfMinHz) / 1000.0;
+        freqsKHz.loKHz = (ifFreq.ifHz + RfFrequency::rfMinHz) / 1000.0;
     }
-    else if (((loFreq.loHz + ifFreq.ifHz) > SC2470::RfFrequency::rfMaxHz))
+    else if (((loFreq.loHz + ifFreq.ifHz) > RfFrequency::rfMaxHz))
     {
-        freqsKHz.loKHz = (SC2470::RfFrequency::rfMaxHz - ifFreq.ifHz) / 1000.0;
+        freqsKHz.loKHz = (RfFrequency::rfMaxHz - ifFreq.ifHz) / 1000.0;
     } 
     else
     {
@@ -176,56 +181,744 @@ SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC
 
     freqsKHz.ifKHz = ifFreq.ifHz / 1000.0;
 
-    m_coProcessor->setFrequencies(path, freqsKHz);
-    return this->getFrequencies(path);
+    return freqsKHz;
 }
 
-SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::FrequencySet freqs) const
+fesd::SC2470Processor::FrequencySet toFrequencySetKHz(fesd::SC2470::FrequencySet freqs)
 {
-    SC2470::FrequencySet coercedFreqs;
-    SC2470Processor::FrequencySet freqsKHz;
+    fesd::SC2470::FrequencySet coercedFreqs;
+    fesd::SC2470Processor::FrequencySet freqsKHz;
 
-    coercedFreqs.rfHz = utility::isAlmostEqualToZero(freqs.rfHz, 0.001) ? 0.0 : SC2470::RfFrequency(freqs.rfHz).rfHz;
-    coercedFreqs.ifHz = utility::isAlmostEqualToZero(freqs.ifHz, 0.001) ? 0.0 : SC2470::IfFrequency(freqs.ifHz).ifHz;
-    coercedFreqs.loHz = utility::isAlmostEqualToZero(freqs.loHz, 0.001) ? 0.0 : SC2470::LoFrequency(freqs.loHz).loHz;
+    coercedFreqs.rfHz = fesd::utility::isAlmostEqualToZero(freqs.rfHz, 0.001) ? 0.0 : fesd::SC2470::RfFrequency(freqs.rfHz).rfHz;
+    coercedFreqs.ifHz = fesd::utility::isAlmostEqualToZero(freqs.ifHz, 0.001) ? 0.0 : fesd::SC2470::IfFrequency(freqs.ifHz).ifHz;
+    coercedFreqs.loHz = fesd::utility::isAlmostEqualToZero(freqs.loHz, 0.001) ? 0.0 : fesd::SC2470::LoFrequency(freqs.loHz).loHz;
 
     freqsKHz.rfKHz = coercedFreqs.rfHz / 1000.0;
     freqsKHz.ifKHz = coercedFreqs.ifHz / 1000.0;
     freqsKHz.loKHz = coercedFreqs.loHz / 1000.0;
 
-    m_coProcessor->setFrequencies(path, freqsKHz);
-    return this->getFrequencies(path);
+    return freqsKHz;
 }
 
-SC2470::FrequencySet SC2470Commander::configureBypassFrequency(SC2470::Path path, SC2470::BypassFrequency byFreq) const
+fesd::SC2470Processor::FrequencySet toFrequencySetKHz(fesd::SC2470::BypassFrequency byFreq)
 {
-    SC2470::FrequencySet freqsHz;
-    SC2470Processor::FrequencySet freqsKHz;
+    fesd::SC2470Processor::FrequencySet freqsKHz;
 
     freqsKHz.loKHz = 0.0;
-
     freqsKHz.rfKHz = byFreq.byHz / 1000.0;
     freqsKHz.ifKHz = byFreq.byHz / 1000.0;
 
-    m_coProcessor->setFrequencies(path, freqsKHz);
-    return this->getFrequencies(path);
+    return freqsKHz;
+}
+
+fesd::SC2470::SynthesizerSettings toSynthesizerSettings(const fesd::SC2470Processor::SynthesizerOutputSet& output)
+{
+    return {output.enable.enable1x, output.enable.enable2x, output.power.power1x, output.power.power2x};
+}
+
+// Frequencies the device sets, the one sent as 0 is derived from the other two unless RF and IF are the same (bypass)
+fesd::SC2470::FrequencySet expectedFrequencies(fesd::SC2470Processor::FrequencySet freqsKHz)
+{
+    const bool bypass = (freqsKHz.loKHz == 0.0) && (freqsKHz.rfKHz == freqsKHz.ifKHz);
+    if (!bypass)
+    {
+        if (freqsKHz.loKHz == 0.0)
+            freqsKHz.loKHz = freqsKHz.rfKHz - freqsKHz.ifKHz;
+        else if (freqsKHz.rfKHz == 0.0)
+            freqsKHz.rfKHz = freqsKHz.loKHz + freqsKHz.ifKHz;
+        else if (freqsKHz.ifKHz == 0.0)
+            freqsKHz.ifKHz = freqsKHz.rfKHz - freqsKHz.loKHz;
+    }
+    return toFrequencySetHz(freqsKHz);
+}
+
+// Values are sent with six decimals, a readback within that resolution matches
+const double ReadbackTolerance = 1.0E-6;
+
+bool sameValue(double a, double b)
+{
+    return fesd::utility::isAlmostEqualToZero(a - b, ReadbackTolerance);
+}
+
+bool sameFrequencies(const fesd::SC2470::FrequencySet& a, const fesd::SC2470::FrequencySet& b)
+{
+    // Compared in kHz, the unit they are sent in
+    return sameValue(a.rfHz / 1000.0, b.rfHz / 1000.0) && sameValue(a.ifHz / 1000.0, b.ifHz / 1000.0) && sameValue(a.loHz / 1000.0, b.loHz / 1000.0);
+}
+
+bool sameSynthesizerSettings(const fesd::SC2470::SynthesizerSettings& a, const fesd::SC2470::SynthesizerSettings& b)
+{
+    return a.enable1x == b.enable1x && a.enable2x == b.enable2x && a.powerLevel1x == b.powerLevel1x && a.powerLevel2x == b.powerLevel2x;
+}
+
+bool sameDCBias(const fesd::SC2470::DCBias& a, const fesd::SC2470::DCBias& b)
+{
+    return a.i == b.i && a.q == b.q;
+}
+
+// Reads the setting from the device even when its shadow state holds it
+template <typename Read>
+auto readBack(Read&& read)
+{
+    const fesd::ShadowState::Refresh refresh;
+    return read();
+}
+
+// Returns the value set without reading it back, under the Deferred policy the readback is verified in the background
+template <typename T, typename ReadAsync, typename Equal>
+T skipReadback(fesd::SC2470::ReadbackPolicy policy, const std::shared_ptr<fesd::ReadbackVerifier>& readbacks, T expected, ReadAsync&& readAsync, Equal equal, const char* setting)
+{
+    if (policy == fesd::SC2470::ReadbackPolicy::Deferred)
+        fesd::ReadbackVerifier::verify(readbacks, readBack(readAsync), expected, equal, setting);
+    return expected;
+}
+
+// Coroutines behind the asynchronous commander operations, they keep the processor alive while in flight.
+// The caller's deadline and cancellation token are captured up front and apply to every step.
+
+// Starts a later step under the caller's token, a step builds its request before it first suspends
+template <typename Start>
+auto startStep(const std::optional<fesd::CancellationToken>& cancellation, Start&& start)
+{
+    if (!cancellation)
+        return start();
+
+    cancellation->throwIfCancelled();
+    fesd::CancellationScope scope(*cancellation);
+    return start();
+}
+
+fesd::AsyncResult<fesd::SC2470::GainLimitsSet> getGainLimitsTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::Deadline deadline)
+{
+    co_return toGainLimits(co_await processor->getGainLimitsAsync(path, deadline));
+}
+
+fesd::AsyncResult<double> configureGainTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, double gainDb, fesd::Deadline deadline, std::optional<fesd::CancellationToken> cancellation)
+{
+    const fesd::SC2470::GainLimitsSet gainLimits = toGainLimits(co_await processor->getGainLimitsAsync(path, deadline));
+    co_return co_await startStep(cancellation, [&]() { return processor->setGainAsync(path, clampGain(gainDb, gainLimits), deadline); });
+}
+
+fesd::AsyncResult<double> getAttenuationTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::Deadline deadline)
+{
+    if (path == fesd::SC2470::Path::TX)
+        co_return co_await processor->getAttnTxAsync(deadline);
+
+    const fesd::SC2470Processor::AttenuatorRxSet rxValues = co_await processor->getAttnRxAsync(deadline);
+    co_return rxValues.attnADb + rxValues.attnBDb;
+}
+
+fesd::AsyncResult<double> configureAttenuationTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, double attenuationDb, fesd::Deadline deadline)
+{
+    attenuationDb = clampAttenuation(path, attenuationDb);
+    if (path == fesd::SC2470::Path::TX)
+        co_return co_await processor->setAttnTxAsync(attenuationDb, deadline);
+
+    const fesd::SC2470Processor::AttenuatorRxSet rxValues = co_await processor->setAttnRxAsync(splitRxAttenuation(attenuationDb), deadline);
+    co_return rxValues.attnADb + rxValues.attnBDb;
+}
+
+fesd::AsyncResult<fesd::SC2470::FrequencySet> getFrequenciesTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::Deadline deadline)
+{
+    co_return toFrequencySetHz(co_await processor->getFrequenciesAsync(path, deadline));
+}
+
+fesd::AsyncResult<fesd::SC2470::FrequencySet> configureFrequenciesTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::SC2470Processor::FrequencySet freqsKHz, fesd::Deadline deadline)
+{
+    co_return toFrequencySetHz(co_await processor->setFrequenciesAsync(path, freqsKHz, deadline));
+}
+
+fesd::AsyncResult<double> getLoFrequencyTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::Deadline deadline)
+{
+    co_return (co_await processor->getLoFrequencyKHzAsync(path, deadline)) * 1000.0;
+}
+
+fesd::AsyncResult<fesd::SC2470::SynthesizerSettings> getSynthesizerSettingsTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::Deadline deadline)
+{
+    co_return toSynthesizerSettings(co_await processor->getSynthOutputAsync(path, deadline));
+}
+
+fesd::AsyncResult<fesd::SC2470::DuplexSetting> getDuplexSettingTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::Deadline deadline)
+{
+    co_return toDuplexSetting(co_await processor->getDuplexStateAsync(deadline));
+}
+
+fesd::AsyncResult<fesd::SC2470::InternalReferenceFrequency> getInternalReferenceOverrideTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, fesd::Deadline deadline)
+{
+    co_return toInternalReferenceFrequency(co_await processor->getSynthReferenceStateAsync(path, deadline));
+}
+
+fesd::AsyncResult<fesd::SC2470::ReferenceSource> getReferenceSourceTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::Deadline deadline)
+{
+    co_return toReferenceSource(co_await processor->getReferenceConfigAsync(deadline));
+}
+
+fesd::AsyncResult<double> configureLoFrequencyTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Path path, double frequencyHz, fesd::Deadline deadline)
+{
+    co_return (co_await processor->setLoFrequencyKHzAsync(path, clampLoFrequencyKHz(frequencyHz / 1000.0), deadline)) * 1000.0;
+}
+
+// Sets the frequencies in kHz, whichever of them the caller gives
+fesd::SC2470::FrequencySet setFrequencies(const std::shared_ptr<fesd::SC2470Processor>& processor, fesd::SC2470::ReadbackPolicy policy, const std::shared_ptr<fesd::ReadbackVerifier>& readbacks, fesd::SC2470::Path path, const fesd::SC2470Processor::FrequencySet& freqsKHz)
+{
+    readbacks->check();
+    processor->setFrequencies(path, freqsKHz);
+    if (policy == fesd::SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return toFrequencySetHz(processor->getFrequencies(path)); });
+    return skipReadback(policy, readbacks, expectedFrequencies(freqsKHz), [&]() { return getFrequenciesTask(processor, path, fesd::DeadlineScope::current()); }, sameFrequencies, "frequencies");
+}
+
+// A hop needs a known path, at least two of its frequencies and no negative dwell
+bool isValidHop(const fesd::SC2470::Hop& hop)
+{
+    if ((hop.path != fesd::SC2470::Path::RX && hop.path != fesd::SC2470::Path::TX) || hop.dwell.count() < 0)
+        return false;
+
+    int derived = 0;
+    for (const double freqHz : {hop.frequencies.rfHz, hop.frequencies.ifHz, hop.frequencies.loHz})
+    {
+        if (!std::isfinite(freqHz) || freqHz < 0.0)
+            return false;
+        derived += fesd::utility::isAlmostEqualToZero(freqHz, 0.001) ? 1 : 0;
+    }
+    return derived <= 1;
+}
+
+// Channel setups of configure()
+
+const fesd::SC2470::Path Paths[] = {fesd::SC2470::Path::RX, fesd::SC2470::Path::TX};
+
+[[noreturn]] void invalidSetting(const char* setting)
+{
+    throw fesd::InvalidArgumentsError(std::string("Invalid ") + setting + " in configuration");
+}
+
+fesd::SC2470Processor::DuplexState toDuplexState(fesd::SC2470::DuplexSetting setting)
+{
+    switch (setting)
+    {
+        case fesd::SC2470::DuplexSetting::Fdd:
+            return {fesd::SC2470Processor::DuplexSetting::FDD, fesd::SC2470::Path::RX};
+        case fesd::SC2470::DuplexSetting::TddRx:
+            return {fesd::SC2470Processor::DuplexSetting::TDD, fesd::SC2470::Path::RX};
+        case fesd::SC2470::DuplexSetting::TddTx:
+            return {fesd::SC2470Processor::DuplexSetting::TDD, fesd::SC2470::Path::TX};
+    }
+    invalidSetting("duplex setting");
+}
+
+fesd::SC2470Processor::ReferenceConfig toReferenceConfig(fesd::SC2470::ReferenceSource source)
+{
+    switch (source)
+    {
+        case fesd::SC2470::ReferenceSource::Internal:
+            return {fesd::SC2470Processor::ClockSource::Internal, fesd::SC2470Processor::ReferenceFreq::Freq100MHz};
+        case fesd::SC2470::ReferenceSource::External10MHz:
+            return {fesd::SC2470Processor::ClockSource::External, fesd::SC2470Processor::ReferenceFreq::Freq10MHz};
+        case fesd::SC2470::ReferenceSource::External100MHz:
+            return {fesd::SC2470Processor::ClockSource::External, fesd::SC2470Processor::ReferenceFreq::Freq100MHz};
+    }
+    invalidSetting("reference source");
+}
+
+fesd::SC2470Processor::SynthesizerReferenceState toSynthesizerReferenceState(fesd::SC2470::InternalReferenceFrequency freq)
+{
+    switch (freq)
+    {
+        case fesd::SC2470::InternalReferenceFrequency::Automatic:
+            return {true, fesd::SC2470Processor::SynthsizerReferenceFreq::Freq100MHz};
+        case fesd::SC2470::InternalReferenceFrequency::Force100MHz:
+            return {false, fesd::SC2470Processor::SynthsizerReferenceFreq::Freq100MHz};
+        case fesd::SC2470::InternalReferenceFrequency::Force105MHz:
+            return {false, fesd::SC2470Processor::SynthsizerReferenceFreq::Freq105MHz};
+    }
+    invalidSetting("internal reference override");
+}
+
+double toAttenuation(fesd::SC2470::Path path, const fesd::SC2470Processor::PathState& state)
+{
+    if (path == fesd::SC2470::Path::TX)
+        return *state.attnTxDb;
+    return state.attnRx->attnADb + state.attnRx->attnBDb;
+}
+
+double toPhaseOffset(const fesd::SC2470Processor::PathState& state)
+{
+    // The phase offset only applies in forced fractional mode
+    return *state.forceFractional ? *state.phase : 0.0;
+}
+
+// Settings the configuration covers, before the change they include what the retunes and the gain clamp depend on
+fesd::SC2470Processor::ChannelQuery toChannelQuery(const fesd::SC2470::Configuration& config, bool beforeChange)
+{
+    fesd::SC2470Processor::ChannelQuery query;
+    query.duplex = config.duplex.has_value();
+    query.reference = config.referenceSource.has_value();
+    query.referenceOutput = config.referenceOutputEnable.has_value();
+
+    for (const fesd::SC2470::Path path : Paths)
+    {
+        const fesd::SC2470::PathConfiguration& settings = config.path(path);
+        fesd::SC2470Processor::PathQuery& read = query.path(path);
+        // The LO is sent again after a reference or fractional mode change
+        read.frequencies = settings.frequencies || (beforeChange && (config.referenceSource || settings.phaseOffset));
+        read.gainLimits = beforeChange && settings.gainDb;
+        read.gain = settings.gainDb.has_value();
+        read.attenuation = settings.attenuationDb.has_value();
+        read.synthOutput = settings.synthesizer.has_value();
+        read.loEnable = settings.loEnable.has_value();
+        read.synthReference = settings.internalReference.has_value();
+        read.phase = settings.phaseOffset.has_value();
+        read.dcBias = settings.dcBias.has_value();
+    }
+    return query;
+}
+
+fesd::SC2470::Configuration toConfiguration(const fesd::SC2470::Configuration& config, const fesd::SC2470Processor::ChannelState& state)
+{
+    fesd::SC2470::Configuration result;
+    if (config.duplex)
+        result.duplex = toDuplexSetting(*state.duplex);
+    if (config.referenceSource)
+        result.referenceSource = toReferenceSource(*state.reference);
+    if (config.referenceOutputEnable)
+        result.referenceOutputEnable = *state.referenceOutput;
+
+    for (const fesd::SC2470::Path path : Paths)
+    {
+        const fesd::SC2470::PathConfiguration& settings = config.path(path);
+        const fesd::SC2470Processor::PathState& read = state.path(path);
+        fesd::SC2470::PathConfiguration& values = result.path(path);
+        if (settings.frequencies)
+            values.frequencies = toFrequencySetHz(*read.frequencies);
+        if (settings.gainDb)
+            values.gainDb = *read.gainDb;
+        if (settings.attenuationDb)
+            values.attenuationDb = toAttenuation(path, read);
+        if (settings.synthesizer)
+            values.synthesizer = toSynthesizerSettings(*read.synthOutput);
+        if (settings.loEnable)
+            values.loEnable = *read.loEnable;
+        if (settings.internalReference)
+            values.internalReference = toInternalReferenceFrequency(*read.synthReference);
+        if (settings.phaseOffset)
+            values.phaseOffset = toPhaseOffset(read);
+        if (settings.dcBias)
+            values.dcBias = *read.dcBias;
+    }
+    return result;
+}
+
+template <typename T, typename Equal>
+bool sameSetting(const std::optional<T>& a, const std::optional<T>& b, Equal equal)
+{
+    if (!a || !b)
+        return a.has_value() == b.has_value();
+    return equal(*a, *b);
+}
+
+bool sameConfiguration(const fesd::SC2470::Configuration& a, const fesd::SC2470::Configuration& b)
+{
+    if (!sameSetting(a.duplex, b.duplex, std::equal_to<fesd::SC2470::DuplexSetting>()) ||
+        !sameSetting(a.referenceSource, b.referenceSource, std::equal_to<fesd::SC2470::ReferenceSource>()) ||
+        !sameSetting(a.referenceOutputEnable, b.referenceOutputEnable, std::equal_to<bool>()))
+        return false;
+
+    for (const fesd::SC2470::Path path : Paths)
+    {
+        const fesd::SC2470::PathConfiguration& x = a.path(path);
+        const fesd::SC2470::PathConfiguration& y = b.path(path);
+        if (!sameSetting(x.frequencies, y.frequencies, sameFrequencies) ||
+            !sameSetting(x.gainDb, y.gainDb, sameValue) ||
+            !sameSetting(x.attenuationDb, y.attenuationDb, sameValue) ||
+            !sameSetting(x.synthesizer, y.synthesizer, sameSynthesizerSettings) ||
+            !sameSetting(x.loEnable, y.loEnable, std::equal_to<bool>()) ||
+            !sameSetting(x.internalReference, y.internalReference, std::equal_to<fesd::SC2470::InternalReferenceFrequency>()) ||
+            !sameSetting(x.phaseOffset, y.phaseOffset, sameValue) ||
+            !sameSetting(x.dcBias, y.dcBias, sameDCBias))
+            return false;
+    }
+    return true;
+}
+
+// Commands that take a channel from its current state to the configuration, with what the driver expects it to be left with
+struct ConfigurationPlan
+{
+    fesd::SC2470Processor::ChannelState changes;
+    fesd::SC2470::Configuration expected;
+    fesd::SC2470Processor::ChannelQuery pendingGains; // Paths whose gain is clamped to the limits at their new frequency
+};
+
+void planPath(fesd::SC2470::Path path, const fesd::SC2470::PathConfiguration& settings, const fesd::SC2470Processor::PathState& current, bool referenceChanged,
+    fesd::SC2470Processor::PathState& changes, fesd::SC2470::PathConfiguration& expected, fesd::SC2470Processor::PathQuery& pendingGains)
+{
+    if (settings.internalReference && toInternalReferenceFrequency(*current.synthReference) != *settings.internalReference)
+        changes.synthReference = toSynthesizerReferenceState(*settings.internalReference);
+
+    // The LO is sent again to follow a new reference and to switch in or out of forced fractional mode, the phase offset needs the latter
+    bool retuned = referenceChanged;
+    std::optional<double> offset;
+    if (settings.phaseOffset)
+    {
+        offset = std::clamp(*settings.phaseOffset, -360.0, 360.0);
+        expected.phaseOffset = offset;
+        const bool forced = (*offset != 0);
+        if (*current.forceFractional != forced)
+        {
+            changes.forceFractional = forced;
+            retuned = true;
+        }
+    }
+
+    bool frequencyChanged = false;
+    if (settings.frequencies)
+    {
+        const fesd::SC2470Processor::FrequencySet freqsKHz = toFrequencySetKHz(*settings.frequencies);
+        expected.frequencies = expectedFrequencies(freqsKHz);
+        frequencyChanged = !sameFrequencies(*expected.frequencies, toFrequencySetHz(*current.frequencies));
+        if (frequencyChanged || retuned)
+        {
+            changes.frequencies = freqsKHz;
+            retuned = true;
+        }
+    }
+    else if (retuned)
+        changes.loKHz = clampLoFrequencyKHz(current.frequencies->loKHz);
+
+    // A retune clears the phase accumulator
+    if (offset && *offset != 0)
+    {
+        const double phase = retuned ? 0.0 : *current.phase;
+        if (retuned || !sameValue(phase, *offset))
+            changes.phaseIncrement = *offset - phase;
+    }
+
+    if (settings.gainDb && frequencyChanged)
+        pendingGains.gainLimits = true;
+    else if (settings.gainDb)
+    {
+        expected.gainDb = clampGain(*settings.gainDb, toGainLimits(*current.gainLimits));
+        if (!sameValue(*expected.gainDb, *current.gainDb))
+            changes.gainDb = expected.gainDb;
+    }
+
+    if (settings.attenuationDb)
+    {
+        expected.attenuationDb = clampAttenuation(path, *settings.attenuationDb);
+        if (!sameValue(*expected.attenuationDb, toAttenuation(path, current)) && path == fesd::SC2470::Path::TX)
+            changes.attnTxDb = expected.attenuationDb;
+        else if (!sameValue(*expected.attenuationDb, toAttenuation(path, current)))
+            changes.attnRx = splitRxAttenuation(*expected.attenuationDb);
+    }
+
+    if (settings.synthesizer && !sameSynthesizerSettings(*settings.synthesizer, toSynthesizerSettings(*current.synthOutput)))
+    {
+        const fesd::SC2470::SynthesizerSettings& synth = *settings.synthesizer;
+        changes.synthOutput = {{synth.powerLevel1x, synth.powerLevel2x}, {synth.enable1x, synth.enable2x}};
+    }
+    if (settings.loEnable && *settings.loEnable != *current.loEnable)
+        changes.loEnable = settings.loEnable;
+    if (settings.dcBias && !sameDCBias(*settings.dcBias, *current.dcBias))
+        changes.dcBias = settings.dcBias;
+}
+
+ConfigurationPlan planConfiguration(const fesd::SC2470::Configuration& config, const fesd::SC2470Processor::ChannelState& current)
+{
+    ConfigurationPlan plan;
+    plan.expected = config;
+
+    if (config.duplex && toDuplexSetting(*current.duplex) != *config.duplex)
+        plan.changes.duplex = toDuplexState(*config.duplex);
+    const bool referenceChanged = config.referenceSource && toReferenceSource(*current.reference) != *config.referenceSource;
+    if (referenceChanged)
+        plan.changes.reference = toReferenceConfig(*config.referenceSource);
+    if (config.referenceOutputEnable && *current.referenceOutput != *config.referenceOutputEnable)
+        plan.changes.referenceOutput = config.referenceOutputEnable;
+
+    for (const fesd::SC2470::Path path : Paths)
+        planPath(path, config.path(path), current.path(path), referenceChanged, plan.changes.path(path), plan.expected.path(path), plan.pendingGains.path(path));
+    return plan;
+}
+
+fesd::AsyncResult<fesd::SC2470::Configuration> getConfigurationTask(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::Configuration config, fesd::SC2470Processor::ChannelQuery query, fesd::Deadline deadline)
+{
+    co_return toConfiguration(config, co_await processor->getChannelStateAsync(query, deadline));
+}
+
+template <typename T>
+void mergeSetting(std::optional<T>& into, const std::optional<T>& from)
+{
+    if (from)
+        into = from;
+}
+
+// Settings given later replace the ones staged before
+void mergeConfiguration(fesd::SC2470::Configuration& into, const fesd::SC2470::Configuration& from)
+{
+    mergeSetting(into.referenceSource, from.referenceSource);
+    mergeSetting(into.referenceOutputEnable, from.referenceOutputEnable);
+    mergeSetting(into.duplex, from.duplex);
+    for (const fesd::SC2470::Path path : Paths)
+    {
+        fesd::SC2470::PathConfiguration& settings = into.path(path);
+        const fesd::SC2470::PathConfiguration& given = from.path(path);
+        mergeSetting(settings.frequencies, given.frequencies);
+        mergeSetting(settings.gainDb, given.gainDb);
+        mergeSetting(settings.attenuationDb, given.attenuationDb);
+        mergeSetting(settings.synthesizer, given.synthesizer);
+        mergeSetting(settings.loEnable, given.loEnable);
+        mergeSetting(settings.internalReference, given.internalReference);
+        mergeSetting(settings.phaseOffset, given.phaseOffset);
+        mergeSetting(settings.dcBias, given.dcBias);
+    }
+}
+
+bool isEmptyConfiguration(const fesd::SC2470::Configuration& config)
+{
+    if (config.referenceSource || config.referenceOutputEnable || config.duplex)
+        return false;
+    for (const fesd::SC2470::Path path : Paths)
+    {
+        const fesd::SC2470::PathConfiguration& settings = config.path(path);
+        if (settings.frequencies || settings.gainDb || settings.attenuationDb || settings.synthesizer || settings.loEnable || settings.internalReference ||
+            settings.phaseOffset || settings.dcBias)
+            return false;
+    }
+    return true;
+}
+
+// Sends the settings of the configuration that differ, ending with CONFIG:APPLY when committing a staged update
+fesd::SC2470::Configuration applyConfiguration(std::shared_ptr<fesd::SC2470Processor> processor, fesd::SC2470::ReadbackPolicy policy, std::shared_ptr<fesd::ReadbackVerifier> readbacks,
+    const fesd::SC2470::Configuration& config, bool commit)
+{
+    const fesd::SC2470Processor::ChannelState current = processor->getChannelState(toChannelQuery(config, true));
+    ConfigurationPlan plan = planConfiguration(config, current);
+
+    // One readback of every setting, appended to the last write
+    const fesd::SC2470Processor::ChannelQuery readback = toChannelQuery(config, false);
+    const fesd::SC2470Processor::ChannelQuery none;
+    const bool always = (policy == fesd::SC2470::ReadbackPolicy::Always);
+    const bool gainsPending = plan.pendingGains.rx.gainLimits || plan.pendingGains.tx.gainLimits;
+    plan.changes.apply = commit && !gainsPending;
+
+    fesd::SC2470Processor::ChannelState written = readBack([&]() { return processor->writeChannelState(plan.changes, gainsPending ? plan.pendingGains : (always ? readback : none)); });
+    if (gainsPending)
+    {
+        fesd::SC2470Processor::ChannelState gains;
+        gains.apply = commit;
+        for (const fesd::SC2470::Path path : Paths)
+        {
+            if (!plan.pendingGains.path(path).gainLimits)
+                continue;
+            const double gainDb = clampGain(*config.path(path).gainDb, toGainLimits(*written.path(path).gainLimits));
+            gains.path(path).gainDb = gainDb;
+            plan.expected.path(path).gainDb = gainDb;
+        }
+        written = readBack([&]() { return processor->writeChannelState(gains, always ? readback : none); });
+    }
+
+    if (always)
+        return toConfiguration(config, written);
+    return skipReadback(policy, readbacks, plan.expected, [&]() { return getConfigurationTask(processor, config, readback, fesd::DeadlineScope::current()); }, sameConfiguration, "configuration");
+}
+
+} // static namespace
+
+namespace fesd
+{
+
+SC2470Commander::SC2470Commander(std::shared_ptr<DeviceDetails> device)
+    : BaseCommander(device),
+    m_coProcessor(std::make_shared<SC2470Processor>(device)),
+    m_readbacks(std::make_shared<ReadbackVerifier>())
+{
+    // Will throw an exception if invalid parameters are given
+    m_genProcessor->getId();
+};
+
+void SC2470Commander::setReadbackPolicy(SC2470::ReadbackPolicy policy)
+{
+    m_readbackPolicy = policy;
+}
+
+SC2470::ReadbackPolicy SC2470Commander::getReadbackPolicy(void) const
+{
+    return m_readbackPolicy;
+}
+
+void SC2470Commander::verifyReadbacks(void) const
+{
+    m_readbacks->wait();
+}
+
+SC2470::GainLimitsSet SC2470Commander::getGainLimits(SC2470::Path path) const
+{
+    return toGainLimits(m_coProcessor->getGainLimits(path));
+}
+
+double SC2470Commander::getGain(SC2470::Path path) const
+{
+    return m_coProcessor->getGain(path);
+}
+
+SC2470::Configuration SC2470Commander::configure(const SC2470::Configuration& config) const
+{
+    m_readbacks->check();
+    return applyConfiguration(m_coProcessor, m_readbackPolicy, m_readbacks, config, false);
+}
+
+void SC2470Commander::stage(const SC2470::Configuration& config)
+{
+    mergeConfiguration(m_staged, config);
+}
+
+SC2470::Configuration SC2470Commander::applyStaged(void)
+{
+    m_readbacks->check();
+    // Nothing staged leaves the device as it is, without a CONFIG:APPLY or a lock wait
+    if (isEmptyConfiguration(m_staged))
+        return SC2470::Configuration();
+    const auto start = std::chrono::steady_clock::now();
+    SC2470::Configuration result = applyConfiguration(m_coProcessor, m_readbackPolicy, m_readbacks, m_staged, true);
+    m_coProcessor->waitForReferenceLock(start);
+    // Kept until the device has taken it, a failed apply can be retried
+    m_staged = SC2470::Configuration();
+    return result;
+}
+
+void SC2470Commander::discardStaged(void)
+{
+    m_staged = SC2470::Configuration();
+}
+
+const SC2470::Configuration& SC2470Commander::getStaged(void) const
+{
+    return m_staged;
+}
+
+SC2470Sweep SC2470Commander::compileSweep(std::span<const SC2470::Hop> hops) const
+{
+    std::vector<std::string> messages;
+    messages.reserve(hops.size());
+    for (std::size_t i = 0; i < hops.size(); i++)
+    {
+        if (!isValidHop(hops[i]))
+            throw InvalidArgumentsError("Invalid hop " + std::to_string(i) + " in sweep");
+        messages.push_back(m_coProcessor->encodeFrequencies(hops[i].path, toFrequencySetKHz(hops[i].frequencies)));
+    }
+    return SC2470Sweep(m_coProcessor, std::vector<SC2470::Hop>(hops.begin(), hops.end()), std::move(messages));
+}
+
+SC2470PreparedSetting SC2470Commander::prepareGain(SC2470::Path path) const
+{
+    return SC2470PreparedSetting(std::make_shared<PreparedCommand>(m_coProcessor->prepareGain(path)));
+}
+
+SC2470PreparedSetting SC2470Commander::preparePhaseIncrement(SC2470::Path path) const
+{
+    return SC2470PreparedSetting(std::make_shared<PreparedCommand>(m_coProcessor->preparePhaseIncrement(path)));
+}
+
+void SC2470Commander::scheduleFrequencies(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, SC2470::Path path, SC2470::FrequencySet freqs) const
+{
+    if (!isValidHop({path, freqs, std::chrono::microseconds::zero()}))
+        throw InvalidArgumentsError("Invalid frequencies in schedule");
+    m_coProcessor->schedule(scheduler, at, {m_coProcessor->encodeFrequencies(path, toFrequencySetKHz(freqs))});
+}
+
+void SC2470Commander::scheduleGain(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, SC2470::Path path, double gainDb) const
+{
+    m_coProcessor->schedule(scheduler, at, {m_coProcessor->encodeGain(path, gainDb)});
+}
+
+void SC2470Commander::scheduleDuplexSetting(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, SC2470::DuplexSetting setting) const
+{
+    const SC2470Processor::DuplexState state = toDuplexState(setting);
+    const bool tdd = (state.rfPath == SC2470Processor::DuplexSetting::TDD);
+    m_coProcessor->schedule(scheduler, at, m_coProcessor->encodeDuplexState(state.rfPath, tdd ? std::optional(state.tddPath) : std::nullopt));
+}
+
+double SC2470Commander::configureGain(SC2470::Path path, double gainDb) const
+{
+    m_readbacks->check();
+    SC2470::GainLimitsSet gainLimits = getGainLimits(path);
+    gainDb = clampGain(gainDb, gainLimits);
+    m_coProcessor->setGain(path, gainDb);
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return this->getGain(path); });
+    return skipReadback(m_readbackPolicy, m_readbacks, gainDb, [&]() { return m_coProcessor->getGainAsync(path, DeadlineScope::current()); }, sameValue, "gain");
+}
+
+double SC2470Commander::getAttenuation(SC2470::Path path) const
+{    
+    if (path == SC2470::Path::TX)
+        return m_coProcessor->getAttnTx();
+    else
+    {
+        SC2470Processor::AttenuatorRxSet rxValues = m_coProcessor->getAttnRx();
+        return rxValues.attnADb + rxValues.attnBDb;
+    }
+}
+
+double SC2470Commander::configureAttenuation(SC2470::Path path, double attenuationDb) const
+{
+    m_readbacks->check();
+    attenuationDb = clampAttenuation(path, attenuationDb);
+    if (path == SC2470::Path::TX)
+        m_coProcessor->setAttnTx(attenuationDb);
+    else
+        m_coProcessor->setAttnRx(splitRxAttenuation(attenuationDb));
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return this->getAttenuation(path); });
+    return skipReadback(m_readbackPolicy, m_readbacks, attenuationDb, [&]() { return getAttenuationTask(m_coProcessor, path, DeadlineScope::current()); }, sameValue, "attenuation");
+}
+
+SC2470::FrequencySet SC2470Commander::getFrequencies(SC2470::Path path) const
+{
+    return toFrequencySetHz(m_coProcessor->getFrequencies(path));
+}
+
+SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::IfFrequency ifFreq) const
+{
+    return setFrequencies(m_coProcessor, m_readbackPolicy, m_readbacks, path, toFrequencySetKHz(rfFreq, ifFreq));
+}
+
+SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::LoFrequency loFreq) const
+{
+    return setFrequencies(m_coProcessor, m_readbackPolicy, m_readbacks, path, toFrequencySetKHz(rfFreq, loFreq));
+}
+
+SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::IfFrequency ifFreq, SC2470::LoFrequency loFreq) const
+{
+    return setFrequencies(m_coProcessor, m_readbackPolicy, m_readbacks, path, toFrequencySetKHz(ifFreq, loFreq));
+}
+
+SC2470::FrequencySet SC2470Commander::configureFrequencies(SC2470::Path path, SC2470::FrequencySet freqs) const
+{
+    return setFrequencies(m_coProcessor, m_readbackPolicy, m_readbacks, path, toFrequencySetKHz(freqs));
+}
 
+SC2470::FrequencySet SC2470Commander::configureBypassFrequency(SC2470::Path path, SC2470::BypassFrequency byFreq) const
+{
+    return setFrequencies(m_coProcessor, m_readbackPolicy, m_readbacks, path, toFrequencySetKHz(byFreq));
 }
 
 
+
 SC2470::SynthesizerSettings SC2470Commander::getSynthesizerSettings(SC2470::Path path) const
 {
-    SC2470Processor::SynthesizerPowerSet power = m_coProcessor->getSynthPowerLevel(path);
-    SC2470Processor::SynthesizerEnableSet enable = m_coProcessor->getSynthEnable(path);
-    return {enable.enable1x, enable.enable2x, power.power1x, power.power2x};
+    return toSynthesizerSettings(m_coProcessor->getSynthOutput(path));
 }
 
 SC2470::SynthesizerSettings SC2470Commander::configureSynthesizerSettings(SC2470::Path path, SC2470::SynthesizerSettings settings) const
 {
-    m_coProcessor->setSynthPowerLevel(path, {settings.powerLevel1x, settings.powerLevel2x});
-    m_coProcessor->setSynthEnable(path, {settings.enable1x, settings.enable2x});
+    m_readbacks->check();
+    const SC2470Processor::SynthesizerOutputSet output{{settings.powerLevel1x, settings.powerLevel2x}, {settings.enable1x, settings.enable2x}};
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return toSynthesizerSettings(m_coProcessor->setSynthOutput(path, output));
 
-    return this->getSynthesizerSettings(path);
+    m_coProcessor->writeSynthOutput(path, output);
+    return skipReadback(m_readbackPolicy, m_readbacks, settings, [&]() { return getSynthesizerSettingsTask(m_coProcessor, path, DeadlineScope::current()); }, sameSynthesizerSettings, "synthesizer settings");
 } 
 
 bool SC2470Commander::getLoEnable(SC2470::Path path) const
@@ -235,65 +928,78 @@ bool SC2470Commander::getLoEnable(SC2470::Path path) const
 
 bool SC2470Commander::configureLoEnable(SC2470::Path path, bool enable) const
 {
+    m_readbacks->check();
     m_coProcessor->setLoClkEnable(path, enable);
-    return this->getLoEnable(path);
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return this->getLoEnable(path); });
+    return skipReadback(m_readbackPolicy, m_readbacks, enable, [&]() { return m_coProcessor->getLoClkEnableAsync(path, DeadlineScope::current()); }, std::equal_to<bool>(), "LO enable");
 }
 
 SC2470::DuplexSetting SC2470Commander::getDuplexSetting(void) const
 {
-    if (m_coProcessor->getRfPath() == SC2470Processor::DuplexSetting::FDD)
-        return SC2470::DuplexSetting::Fdd;
-    if (m_coProcessor->getTddPath() == SC2470::Path::TX)
-        return SC2470::DuplexSetting::TddTx;
-    return SC2470::DuplexSetting::TddRx;
+    return toDuplexSetting(m_coProcessor->getDuplexState());
 }
 
 SC2470::DuplexSetting SC2470Commander::configureDuplexSetting(SC2470::DuplexSetting setting) const
 {
+    SC2470Processor::DuplexSetting duplex;
+    std::optional<SC2470::Path> tddPath;
+
+    m_readbacks->check();
     switch (setting)
     {
         case SC2470::DuplexSetting::Fdd:
-            m_coProcessor->setRfPath(SC2470Processor::DuplexSetting::FDD);
+            duplex = SC2470Processor::DuplexSetting::FDD;
             break;
         case SC2470::DuplexSetting::TddRx:
-            m_coProcessor->setRfPath(SC2470Processor::DuplexSetting::TDD);
-            m_coProcessor->setTddPath(SC2470::Path::RX);
+            duplex = SC2470Processor::DuplexSetting::TDD;
+            tddPath = SC2470::Path::RX;
             break;
         case SC2470::DuplexSetting::TddTx:
-            m_coProcessor->setRfPath(SC2470Processor::DuplexSetting::TDD);
-            m_coProcessor->setTddPath(SC2470::Path::TX);
+            duplex = SC2470Processor::DuplexSetting::TDD;
+            tddPath = SC2470::Path::TX;
             break;
+        default:
+            return this->getDuplexSetting();
     }
 
-    return this->getDuplexSetting();
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return toDuplexSetting(m_coProcessor->setDuplexState(duplex, tddPath));
+
+    m_coProcessor->writeDuplexState(duplex, tddPath);
+    return skipReadback(m_readbackPolicy, m_readbacks, setting, [&]() { return getDuplexSettingTask(m_coProcessor, DeadlineScope::current()); }, std::equal_to<SC2470::DuplexSetting>(), "duplex setting");
 }
 
 SC2470::InternalReferenceFrequency SC2470Commander::getInternalReferenceOverride(SC2470::Path path) const
 {
-    if(m_coProcessor->getSynthReferenceAuto(path)) {
-        return SC2470::InternalReferenceFrequency::Automatic;
-    } else if (m_coProcessor->getSynthReferenceFrequency(path) == SC2470Processor::SynthsizerReferenceFreq::Freq100MHz)
-        return SC2470::InternalReferenceFrequency::Force100MHz;
-    return SC2470::InternalReferenceFrequency::Force105MHz;
+    return toInternalReferenceFrequency(m_coProcessor->getSynthReferenceState(path));
 }
 
 SC2470::InternalReferenceFrequency SC2470Commander::configureInternalReferenceOverride(SC2470::Path path, SC2470::InternalReferenceFrequency freq) const
 {
+    bool automatic = false;
+    std::optional<SC2470Processor::SynthsizerReferenceFreq> referenceFreq;
+
+    m_readbacks->check();
     switch(freq) {
     case SC2470::InternalReferenceFrequency::Automatic:
-        m_coProcessor->setSynthReferenceAuto(path, true);
+        automatic = true;
         break;
     case SC2470::InternalReferenceFrequency::Force100MHz:
-        m_coProcessor->setSynthReferenceAuto(path, false);
-        m_coProcessor->setSynthReferenceFrequency(path, SC2470Processor::SynthsizerReferenceFreq::Freq100MHz);
+        referenceFreq = SC2470Processor::SynthsizerReferenceFreq::Freq100MHz;
         break;
     case SC2470::InternalReferenceFrequency::Force105MHz:
-        m_coProcessor->setSynthReferenceAuto(path, false);
-        m_coProcessor->setSynthReferenceFrequency(path, SC2470Processor::SynthsizerReferenceFreq::Freq105MHz);
+        referenceFreq = SC2470Processor::SynthsizerReferenceFreq::Freq105MHz;
         break;
+    default:
+        return this->getInternalReferenceOverride(path);
     }
 
-    return this->getInternalReferenceOverride(path);
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return toInternalReferenceFrequency(m_coProcessor->setSynthReferenceState(path, automatic, referenceFreq));
+
+    m_coProcessor->writeSynthReferenceState(path, automatic, referenceFreq);
+    return skipReadback(m_readbackPolicy, m_readbacks, freq, [&]() { return getInternalReferenceOverrideTask(m_coProcessor, path, DeadlineScope::current()); }, std::equal_to<SC2470::InternalReferenceFrequency>(), "internal reference override");
 }
 
 
@@ -304,65 +1010,60 @@ double SC2470Commander::getLoFrequency(SC2470::Path path) const
 
 double SC2470Commander::configureLoFrequency(SC2470::Path path, double frequencyHz) const
 {
-    if (frequencyHz < SC2470::LoFrequency::loMinHz)
-        frequencyHz = SC2470::LoFrequency::loMinHz;
-    if (frequencyHz > SC2470::LoFrequency::loMaxHz)
-        frequencyHz = SC2470::LoFrequency::loMaxHz;
-
-    m_coProcessor->setLoFrequencyKHz(path, (frequencyHz / 1000.0));
-
-    return this->getLoFrequency(path);
+    m_readbacks->check();
+    const double frequencyKHz = clampLoFrequencyKHz(frequencyHz / 1000.0);
+    m_coProcessor->setLoFrequencyKHz(path, frequencyKHz);
+
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return this->getLoFrequency(path); });
+    // Compared in kHz, the unit it is sent in
+    return skipReadback(m_readbackPolicy, m_readbacks, frequencyKHz, [&]() { return m_coProcessor->getLoFrequencyKHzAsync(path, DeadlineScope::current()); }, sameValue, "LO frequency") * 1000.0;
 }
 
 SC2470::ReferenceSource SC2470Commander::configureReferenceSource(SC2470::ReferenceSource source) const 
 {
-    SC2470Processor::ReferenceConfig config;
+    return switchReferenceSource(source).source;
+}
+
+SC2470::ReferenceSwitch SC2470Commander::switchReferenceSource(SC2470::ReferenceSource source) const
+{
+    SC2470Processor::ReferenceConfig config{SC2470Processor::ClockSource::Internal, SC2470Processor::ReferenceFreq::Freq100MHz};
 
-    double freqRx = m_coProcessor->getLoFrequencyKHz(SC2470::Path::RX);
-    double freqTx = m_coProcessor->getLoFrequencyKHz(SC2470::Path::TX);
+    m_readbacks->check();
+    SC2470Processor::LoFrequencySet loKHz = m_coProcessor->getLoFrequenciesKHz();
 
     switch (source)
     {
         case SC2470::ReferenceSource::Internal:
             config.clkSource = SC2470Processor::ClockSource::Internal;
-            m_coProcessor->setReferenceConfig(config);
             break;
         case SC2470::ReferenceSource::External10MHz:
             config.clkSource = SC2470Processor::ClockSource::External;
             config.freqSel = SC2470Processor::ReferenceFreq::Freq10MHz;
-            m_coProcessor->setReferenceConfig(config);            
             break;
         case SC2470::ReferenceSource::External100MHz:
             config.clkSource = SC2470Processor::ClockSource::External;
             config.freqSel = SC2470Processor::ReferenceFreq::Freq100MHz;
-            m_coProcessor->setReferenceConfig(config);            
             break;
         default:
+            config = m_coProcessor->getReferenceConfig();
             break; 
     }
 
-    // Reconfigure frequencies after changing source
-    this->configureLoFrequency(SC2470::Path::RX, freqRx);
-    this->configureLoFrequency(SC2470::Path::TX, freqTx);
-    
-    return this->getReferenceSource();
+    // Reconfigure frequencies after changing source, pipelined behind the reference change
+    loKHz.rxKHz = clampLoFrequencyKHz(loKHz.rxKHz);
+    loKHz.txKHz = clampLoFrequencyKHz(loKHz.txKHz);
+
+    const bool readback = (m_readbackPolicy == SC2470::ReadbackPolicy::Always);
+    const SC2470Processor::ReferenceSwitch result = m_coProcessor->switchReference(config, loKHz, readback);
+    if (readback)
+        return {toReferenceSource(*result.readback), result.timeToLock};
+    return {skipReadback(m_readbackPolicy, m_readbacks, toReferenceSource(config), [&]() { return getReferenceSourceTask(m_coProcessor, DeadlineScope::current()); }, std::equal_to<SC2470::ReferenceSource>(), "reference source"), result.timeToLock};
 }
 
 SC2470::ReferenceSource SC2470Commander::getReferenceSource(void) const
 {
-    SC2470Processor::ReferenceConfig config = m_coProcessor->getReferenceConfig();
-
-    if (config.clkSource == SC2470Processor::ClockSource::Internal)
-        return SC2470::ReferenceSource::Internal;
-    else if (config.clkSource== SC2470Processor::ClockSource::External)
-    {
-        if (config.freqSel == SC2470Processor::ReferenceFreq::Freq10MHz)
-            return SC2470::ReferenceSource::External10MHz;
-        else if (config.freqSel == SC2470Processor::ReferenceFreq::Freq100MHz)
-            return SC2470::ReferenceSource::External100MHz;
-    }
-
-    throw CommunicationError("Invalid response from device...");
+    return toReferenceSource(m_coProcessor->getReferenceConfig());
 }
 
 SC2470::SynthesizerMode SC2470Commander::getSynthesizerMode(SC2470::Path path) const
@@ -379,6 +1080,7 @@ SC2470::SynthesizerMode SC2470Commander::getSynthesizerMode(SC2470::Path path) c
 
 double SC2470Commander::configurePhaseOffset(SC2470::Path path, double offset) const 
 {
+    m_readbacks->check();
     double freqHz = this->getLoFrequency(path);
 
     if (offset == 0)
@@ -387,7 +1089,9 @@ double SC2470Commander::configurePhaseOffset(SC2470::Path path, double offset) c
         m_coProcessor->setForceFractionalMode(path, false);
         // We must reissue freq command for the synth to switch out of fractional mode
         this->configureLoFrequency(path, freqHz);  // this resets phase to 0
-        return this->getPhaseOffset(path);
+        if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+            return readBack([&]() { return this->getPhaseOffset(path); });
+        return skipReadback(m_readbackPolicy, m_readbacks, 0.0, [&]() { return m_coProcessor->getPhaseAccumulatorAsync(path, DeadlineScope::current()); }, sameValue, "phase offset");
     }
 
     if (!m_coProcessor->getForceFractionalMode(path))
@@ -406,7 +1110,9 @@ double SC2470Commander::configurePhaseOffset(SC2470::Path path, double offset) c
     double increment = offset - currentPhase;
     m_coProcessor->incrementPhase(path, increment);
 
-    return m_coProcessor->getPhaseAccumulator(path); 
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return m_coProcessor->getPhaseAccumulator(path); });
+    return skipReadback(m_readbackPolicy, m_readbacks, offset, [&]() { return m_coProcessor->getPhaseAccumulatorAsync(path, DeadlineScope::current()); }, sameValue, "phase offset");
 }
 
 double SC2470Commander::getPhaseOffset(SC2470::Path path) const
@@ -418,8 +1124,11 @@ double SC2470Commander::getPhaseOffset(SC2470::Path path) const
 
 SC2470::DCBias SC2470Commander::configureDCBias(SC2470::Path path, SC2470::DCBias bias) const
 {
+    m_readbacks->check();
     m_coProcessor->setDCBias(path, bias);
-    return this->getDCBias(path);
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return this->getDCBias(path); });
+    return skipReadback(m_readbackPolicy, m_readbacks, bias, [&]() { return m_coProcessor->getDCBiasAsync(path, DeadlineScope::current()); }, sameDCBias, "DC bias");
 }   
 
 SC2470::DCBias SC2470Commander::getDCBias(SC2470::Path path) const
@@ -427,10 +1136,49 @@ SC2470::DCBias SC2470Commander::getDCBias(SC2470::Path path) const
     return m_coProcessor->getDCBias(path);
 }
 
+double SC2470Commander::getPaTemperature(void) const
+{
+    return m_coProcessor->getPaTemp();
+}
+
+double SC2470Commander::getReferenceLockDetect(void) const
+{
+    return m_coProcessor->getReferenceLockDetect();
+}
+
+std::chrono::nanoseconds SC2470Commander::waitForLock(std::chrono::milliseconds timeout) const
+{
+    const auto start = std::chrono::steady_clock::now();
+    const std::optional<std::chrono::nanoseconds> settled = m_coProcessor->pollReferenceLock(start, start + timeout);
+    if (!settled.has_value())
+        throw CommunicationError("Device did not lock within the timeout");
+    return settled.value();
+}
+
+std::chrono::nanoseconds SC2470Commander::waitForSettled(void) const
+{
+    const auto start = std::chrono::steady_clock::now();
+    m_readbacks->wait();
+    return m_coProcessor->waitForReferenceLock(start);
+}
+
+SettleStats SC2470Commander::getSettleStats(void) const
+{
+    return m_coProcessor->getSettleStats();
+}
+
+void SC2470Commander::resetSettleStats(void) const
+{
+    m_coProcessor->resetSettleStats();
+}
+
 bool SC2470Commander::configureReferenceOutputEnable(bool enable) const
 {
+    m_readbacks->check();
     m_coProcessor->setReferenceOutputEnable(enable);
-    return this->getReferenceOutputEnable();
+    if (m_readbackPolicy == SC2470::ReadbackPolicy::Always)
+        return readBack([&]() { return this->getReferenceOutputEnable(); });
+    return skipReadback(m_readbackPolicy, m_readbacks, enable, [&]() { return m_coProcessor->getReferenceOutputEnableAsync(DeadlineScope::current()); }, std::equal_to<bool>(), "reference output enable");
 }
 
 bool SC2470Commander::getReferenceOutputEnable(void) const
@@ -438,4 +1186,69 @@ bool SC2470Commander::getReferenceOutputEnable(void) const
     return m_coProcessor->getReferenceOutputEnable();
 }
 
+AsyncResult<double> SC2470Commander::configureGainAsync(SC2470::Path path, double gainDb) const
+{
+    return configureGainTask(m_coProcessor, path, gainDb, DeadlineScope::current(), CancellationScope::current());
+}
+
+AsyncResult<double> SC2470Commander::configureAttenuationAsync(SC2470::Path path, double attenuationDb) const
+{
+    return configureAttenuationTask(m_coProcessor, path, attenuationDb, DeadlineScope::current());
+}
+
+AsyncResult<SC2470::FrequencySet> SC2470Commander::configureFrequenciesAsync(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::IfFrequency ifFreq) const
+{
+    return configureFrequenciesTask(m_coProcessor, path, toFrequencySetKHz(rfFreq, ifFreq), DeadlineScope::current());
+}
+
+AsyncResult<SC2470::FrequencySet> SC2470Commander::configureFrequenciesAsync(SC2470::Path path, SC2470::RfFrequency rfFreq, SC2470::LoFrequency loFreq) const
+{
+    return configureFrequenciesTask(m_coProcessor, path, toFrequencySetKHz(rfFreq, loFreq), DeadlineScope::current());
+}
+
+AsyncResult<SC2470::FrequencySet> SC2470Commander::configureFrequenciesAsync(SC2470::Path path, SC2470::IfFrequency ifFreq, SC2470::LoFrequency loFreq) const
+{
+    return configureFrequenciesTask(m_coProcessor, path, toFrequencySetKHz(ifFreq, loFreq), DeadlineScope::current());
+}
+
+AsyncResult<SC2470::FrequencySet> SC2470Commander::configureFrequenciesAsync(SC2470::Path path, SC2470::FrequencySet freqs) const
+{
+    return configureFrequenciesTask(m_coProcessor, path, toFrequencySetKHz(freqs), DeadlineScope::current());
+}
+
+AsyncResult<SC2470::FrequencySet> SC2470Commander::configureBypassFrequencyAsync(SC2470::Path path, SC2470::BypassFrequency byFreq) const
+{
+    return configureFrequenciesTask(m_coProcessor, path, toFrequencySetKHz(byFreq), DeadlineScope::current());
+}
+
+AsyncResult<double> SC2470Commander::configureLoFrequencyAsync(SC2470::Path path, double frequencyHz) const
+{
+    return configureLoFrequencyTask(m_coProcessor, path, frequencyHz, DeadlineScope::current());
+}
+
+AsyncResult<SC2470::GainLimitsSet> SC2470Commander::getGainLimitsAsync(SC2470::Path path) const
+{
+    return getGainLimitsTask(m_coProcessor, path, DeadlineScope::current());
+}
+
+AsyncResult<double> SC2470Commander::getGainAsync(SC2470::Path path) const
+{
+    return m_coProcessor->getGainAsync(path, DeadlineScope::current());
+}
+
+AsyncResult<double> SC2470Commander::getAttenuationAsync(SC2470::Path path) const
+{
+    return getAttenuationTask(m_coProcessor, path, DeadlineScope::current());
+}
+
+AsyncResult<SC2470::FrequencySet> SC2470Commander::getFrequenciesAsync(SC2470::Path path) const
+{
+    return getFrequenciesTask(m_coProcessor, path, DeadlineScope::current());
+}
+
+AsyncResult<double> SC2470Commander::getLoFrequencyAsync(SC2470::Path path) const
+{
+    return getLoFrequencyTask(m_coProcessor, path, DeadlineScope::current());
+}
+
 } // namespace fesd
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include <fesd/SC2470PreparedSetting.hpp>
+#include "PreparedCommand.hpp"
+
+namespace fesd {
+
+SC2470PreparedSetting::SC2470PreparedSetting(std::shared_ptr<PreparedCommand> command)
+    : m_command(std::move(command))
+{
+}
+
+void SC2470PreparedSetting::set(double value)
+{
+    m_command->send({value});
+}
+
+} // namespace fesd
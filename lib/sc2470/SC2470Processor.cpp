@@ -1,178 +1,542 @@
 #include "SC2470Processor.hpp"
 #include "DeviceConnection.hpp"
 #include "MessageBuilder.hpp"
+#include "ResponseParser.hpp"
 #include "Utility.hpp"
 #include <fesd/types/Exception.hpp>
 
-#include <boost/algorithm/string.hpp>
-#include <map>
-#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace {
 // Commands
-// const std::string paBiasCurrent = "BIAS:CUR";
-// const std::string paBiasVolt = "BIAS:BVOLT";
-const std::string paDrainVolt = "BIAS:PAVOLT";
-const std::string paBiasTemp = "BIAS:TEMP";
-
-const std::string configApply = "CONFIG:APPLY";
-const std::string configDefault = "CONFIG:DEFAULT";
-const std::string configLoad = "CONFIG:LOAD";
-const std::string configSave = "CONFIG:SAVE";
-const std::string configAutoLoad = "CONFIG:AUTOLOAD";
-const std::string configAutoPhase = "CONFIG:AUTOPHASE";
-
-const std::string ifPathAttn = "IFPATH:ATTN";
-const std::string ifPathDCBias = "IFPATH:DCBIAS";
-
-const std::string loClkFreq = "LOCLK:FREQ";
-const std::string loClkEn = "LOCLK:EN";
-const std::string phaseIncrement = "LOCLK:PHINC";
-const std::string phaseAccumulator = "LOCLK:PHCUMU";
-
-const std::string pathFreq = "PATH:FREQ";
-const std::string pathGain = "PATH:GAIN";
-const std::string pathGainLim = "PATH:GAINLIM";
-
-const std::string refDac = "REFDAC:DAC";
-const std::string refConfig = "REFPLL:CONFIG";
-const std::string refLockDetect = "REFPLL:LD";
-const std::string refOutputEnable = "REFPLL:OUTPUT";
-
-const std::string rfPathPath = "RFPATH:PATH";
-const std::string rfPathTdd = "RFPATH:TDD";
-const std::string rfPathAttn = "RFPATH:ATTN";
-
-const std::string synthPower = "SYN:POW";
-const std::string synthRefFreq = "SYN:REFFREQ";
-const std::string synthRefAuto = "SYN:AUTOREF";
-const std::string synthRefSource = "SYN:REFSRC";
-const std::string synthFractionalMode = "SYN:FFRAC";
-const std::string synthEnable = "SYN:EN";
-const std::string synthRfSet = "SYN:RFSET";
-
-const std::map<fesd::SC2470::Path, std::string> PathStringMap = {
+// constexpr std::string_view paBiasCurrent = "BIAS:CUR";
+// constexpr std::string_view paBiasVolt = "BIAS:BVOLT";
+constexpr std::string_view paDrainVolt = "BIAS:PAVOLT";
+constexpr std::string_view paBiasTemp = "BIAS:TEMP";
+
+constexpr std::string_view configApply = "CONFIG:APPLY";
+constexpr std::string_view configDefault = "CONFIG:DEFAULT";
+constexpr std::string_view configLoad = "CONFIG:LOAD";
+constexpr std::string_view configSave = "CONFIG:SAVE";
+constexpr std::string_view configAutoLoad = "CONFIG:AUTOLOAD";
+constexpr std::string_view configAutoPhase = "CONFIG:AUTOPHASE";
+
+constexpr std::string_view ifPathAttn = "IFPATH:ATTN";
+constexpr std::string_view ifPathDCBias = "IFPATH:DCBIAS";
+
+constexpr std::string_view loClkFreq = "LOCLK:FREQ";
+constexpr std::string_view loClkEn = "LOCLK:EN";
+constexpr std::string_view phaseIncrement = "LOCLK:PHINC";
+constexpr std::string_view phaseAccumulator = "LOCLK:PHCUMU";
+
+constexpr std::string_view pathFreq = "PATH:FREQ";
+constexpr std::string_view pathGain = "PATH:GAIN";
+constexpr std::string_view pathGainLim = "PATH:GAINLIM";
+
+constexpr std::string_view refDac = "REFDAC:DAC";
+constexpr std::string_view refConfig = "REFPLL:CONFIG";
+constexpr std::string_view refLockDetect = "REFPLL:LD";
+constexpr std::string_view refOutputEnable = "REFPLL:OUTPUT";
+
+constexpr std::string_view rfPathPath = "RFPATH:PATH";
+constexpr std::string_view rfPathTdd = "RFPATH:TDD";
+constexpr std::string_view rfPathAttn = "RFPATH:ATTN";
+
+constexpr std::string_view synthPower = "SYN:POW";
+constexpr std::string_view synthRefFreq = "SYN:REFFREQ";
+constexpr std::string_view synthRefAuto = "SYN:AUTOREF";
+constexpr std::string_view synthRefSource = "SYN:REFSRC";
+constexpr std::string_view synthFractionalMode = "SYN:FFRAC";
+constexpr std::string_view synthEnable = "SYN:EN";
+constexpr std::string_view synthRfSet = "SYN:RFSET";
+
+constexpr fesd::utility::Table<fesd::SC2470::Path, std::string_view, 2> PathStringMap = {{
    {fesd::SC2470::Path::RX, "RX"},
    {fesd::SC2470::Path::TX, "TX"},
-};
+}};
 
-const std::map<fesd::SC2470Processor::ClockSource, std::string> ClockSourceStringMap = {
+constexpr fesd::utility::Table<fesd::SC2470Processor::ClockSource, std::string_view, 2> ClockSourceStringMap = {{
    {fesd::SC2470Processor::ClockSource::External, "EXT"},
    {fesd::SC2470Processor::ClockSource::Internal, "INT"},
-};
+}};
 
-const std::map<bool, std::string> EnableStringMap = {
+constexpr fesd::utility::Table<bool, std::string_view, 2> EnableStringMap = {{
    {false, "OFF"},
    {true,  "ON" },
-};
+}};
 
-const std::map<fesd::SC2470Processor::ReferenceFreq, double> ReferenceFreqKhzMap = {
+constexpr fesd::utility::Table<fesd::SC2470Processor::ReferenceFreq, double, 2> ReferenceFreqKhzMap = {{
    {fesd::SC2470Processor::ReferenceFreq::Freq10MHz,  10000.0 },
    {fesd::SC2470Processor::ReferenceFreq::Freq100MHz, 100000.0},
-};
+}};
 
-const std::map<fesd::SC2470Processor::SynthsizerReferenceFreq, double> SynthReferenceFreqKhzMap = {
+constexpr fesd::utility::Table<fesd::SC2470Processor::SynthsizerReferenceFreq, double, 2> SynthReferenceFreqKhzMap = {{
    {fesd::SC2470Processor::SynthsizerReferenceFreq::Freq100MHz, 100000.0},
    {fesd::SC2470Processor::SynthsizerReferenceFreq::Freq105MHz, 105000.0},
-};
+}};
 
-const std::map<fesd::SC2470Processor::DuplexSetting, std::string> DuplexStringMap = {
+constexpr fesd::utility::Table<fesd::SC2470Processor::DuplexSetting, std::string_view, 2> DuplexStringMap = {{
    {fesd::SC2470Processor::DuplexSetting::FDD, "FDD"},
    {fesd::SC2470Processor::DuplexSetting::TDD, "TDD"},
-};
+}};
+
+// Lock detect polls back off between these intervals, the first depends on how fast the device has settled so far
+constexpr std::chrono::microseconds MinLockPollInterval(50);
+constexpr std::chrono::microseconds MaxLockPollInterval(1000);
 
 inline void throwCommsError(void)
 {
     throw fesd::CommunicationError("Invalid response from device...");
 }
 
+fesd::SC2470Processor::DuplexSetting parseRfPath(const std::string& result)
+{
+    for (const auto& [key, value] : DuplexStringMap)
+    {
+        if (result.substr(0, 3).compare(value) == 0) return key;
+    }
+
+    throwCommsError();
+    // Never gets here, this is to fix warning
+    return fesd::SC2470Processor::DuplexSetting::FDD;
+}
+
+fesd::SC2470::Path parseTddPath(const std::string& result)
+{
+    for (const auto& [key, value] : PathStringMap)
+    {
+        if (result.compare(value) == 0) return key;
+    }
+
+    throwCommsError();
+    // Never gets here, this is to fix warning
+    return fesd::SC2470::Path::RX;
+}
+
+fesd::SC2470Processor::SynthesizerPowerSet parseSynthPowerLevel(std::string_view result)
+{
+    const auto [power1x, power2x] = fesd::ResponseParser::fields<uint16_t, uint16_t>(result);
+    return {power1x, power2x};
+}
+
+fesd::SC2470Processor::SynthesizerEnableSet parseSynthEnable(std::string_view result)
+{
+    fesd::ResponseParser parser(result);
+    const std::string_view enable1x = parser.text();
+    const std::string_view enable2x = parser.text();
+    if (!parser.done())
+        throwCommsError();
+
+    const std::string_view on = fesd::utility::at(EnableStringMap, true);
+    return {enable1x == on, enable2x == on};
+}
+
+bool parseSynthReferenceAuto(std::string_view result)
+{
+    if (result == "0") return false;
+    else if (result == "1") return true;
+    throwCommsError();
+    // Never gets here, this is to fix warning
+    return false;
+}
+
+fesd::SC2470Processor::SynthsizerReferenceFreq parseSynthReferenceFrequency(std::string_view response)
+{
+    const double result = fesd::ResponseParser::value<double>(response);
+
+    for (const auto& [key, value] : SynthReferenceFreqKhzMap)
+    {
+        if (fesd::utility::isAlmostEqual(result, value)) return key;
+    }
+
+    throwCommsError();
+    // Never gets here, this is to fix warning
+    return fesd::SC2470Processor::SynthsizerReferenceFreq::Freq100MHz;
+}
+
+fesd::SC2470Processor::ReferenceConfig parseReferenceConfig(std::string_view result)
+{
+    fesd::SC2470Processor::ReferenceConfig returnValues;
+    // Clock source, then frequency
+    const auto [clkSource, freqKhz] = fesd::ResponseParser::fields<std::string_view, double>(result);
+    bool setFlag = false;
+
+    for (const auto& [key, value] : ClockSourceStringMap)
+    {
+        if (clkSource == value)
+        {
+            returnValues.clkSource = key;
+            setFlag = true;
+            break;
+        }
+    }
+
+    if (!setFlag) throwCommsError();
+
+    setFlag = false;
+    for (const auto& [key, value] : ReferenceFreqKhzMap)
+    {
+        if (fesd::utility::isAlmostEqual(freqKhz, value))
+        {
+            returnValues.freqSel = key;
+            setFlag = true;
+            break;
+        }
+    }
+
+    if (!setFlag) throwCommsError();
+
+    return returnValues;
+}
+
+fesd::SC2470Processor::GainLimitsSet parseGainLimits(std::string_view result)
+{
+    const auto [minimum, maximum] = fesd::ResponseParser::fields<double, double>(result);
+    return {minimum, maximum};
+}
+
+fesd::SC2470Processor::AttenuatorRxSet parseAttnRx(std::string_view result)
+{
+    const auto [attnA, attnB] = fesd::ResponseParser::fields<double, double>(result);
+    return {attnA, attnB};
+}
+
+bool parseEnable(std::string_view result)
+{
+    for (const auto& [key, value] : EnableStringMap)
+    {
+        if (result == value) return key;
+    }
+
+    throwCommsError();
+    // Never gets here, this is to fix warning
+    return false;
+}
+
+fesd::SC2470::DCBias parseDCBias(std::string_view result)
+{
+    fesd::SC2470::DCBias bias;
+    std::tie(bias.i, bias.q) = fesd::ResponseParser::fields<int, int>(result);
+    return bias;
+}
+
+fesd::SC2470Processor::FrequencySet parseFrequencies(std::string_view result)
+{
+    fesd::SC2470Processor::FrequencySet resultSet;
+    std::tie(resultSet.rfKHz, resultSet.ifKHz, resultSet.loKHz) = fesd::ResponseParser::fields<double, double, double>(result);
+    return resultSet;
+}
+
+std::string buildReferenceConfigCommand(uint16_t slotId, const fesd::SC2470Processor::ReferenceConfig& config)
+{
+    double frequencyKhz;
+
+    // Clock must be 100000 when clock sournce is Internal
+    if (config.clkSource == fesd::SC2470Processor::ClockSource::Internal) frequencyKhz = fesd::utility::at(ReferenceFreqKhzMap, fesd::SC2470Processor::ReferenceFreq::Freq100MHz);
+    else frequencyKhz = fesd::utility::at(ReferenceFreqKhzMap, config.freqSel);
+
+    return fesd::MessageBuilder::buildCommand(refConfig, slotId, {fesd::utility::at(ClockSourceStringMap, config.clkSource), frequencyKhz});
+}
+
+// Commands of the pipelined set operations, the set operations append their readback queries
+
+std::vector<std::string> synthOutputCommands(uint16_t slotId, fesd::SC2470::Path path, const fesd::SC2470Processor::SynthesizerOutputSet& settings)
+{
+    const fesd::MessageBuilder::Params powerParams{settings.power.power1x, settings.power.power2x};
+    const fesd::MessageBuilder::Params enableParams{fesd::utility::at(EnableStringMap, settings.enable.enable1x), fesd::utility::at(EnableStringMap, settings.enable.enable2x)};
+    return {
+        fesd::MessageBuilder::buildCommand(synthPower, slotId, path, powerParams),
+        fesd::MessageBuilder::buildCommand(synthEnable, slotId, path, enableParams),
+    };
+}
+
+std::vector<std::string> duplexStateCommands(uint16_t slotId, fesd::SC2470Processor::DuplexSetting duplex, std::optional<fesd::SC2470::Path> tddPath)
+{
+    std::vector<std::string> messages{fesd::MessageBuilder::buildCommand(rfPathPath, slotId, {fesd::utility::at(DuplexStringMap, duplex)})};
+    if (tddPath.has_value())
+        messages.push_back(fesd::MessageBuilder::buildCommand(rfPathTdd, slotId, tddPath.value()));
+    return messages;
+}
+
+std::vector<std::string> synthReferenceStateCommands(uint16_t slotId, fesd::SC2470::Path path, bool automatic, std::optional<fesd::SC2470Processor::SynthsizerReferenceFreq> freq)
+{
+    std::vector<std::string> messages{fesd::MessageBuilder::buildCommand(synthRefAuto, slotId, path, {automatic})};
+    if (freq.has_value())
+        messages.push_back(fesd::MessageBuilder::buildCommand(synthRefFreq, slotId, path, {fesd::utility::at(SynthReferenceFreqKhzMap, freq.value())}));
+    return messages;
+}
+
+std::vector<std::string> referenceConfigAndLoCommands(uint16_t slotId, const fesd::SC2470Processor::ReferenceConfig& config, fesd::SC2470Processor::LoFrequencySet loKHz)
+{
+    return {
+        buildReferenceConfigCommand(slotId, config),
+        fesd::MessageBuilder::buildCommand(loClkFreq, slotId, fesd::SC2470::Path::RX, {loKHz.rxKHz}),
+        fesd::MessageBuilder::buildCommand(loClkFreq, slotId, fesd::SC2470::Path::TX, {loKHz.txKHz}),
+    };
+}
+
+// Sends pipelined commands, throws if the device did not accept one of them
+void transactCommands(const fesd::DeviceConnection& connection, const std::vector<std::string>& messages)
+{
+    for (const fesd::TransactionResult& result : connection.transact(messages))
+        result.value();
+}
+
+void append(std::vector<std::string>& messages, std::vector<std::string> more)
+{
+    messages.insert(messages.end(), std::make_move_iterator(more.begin()), std::make_move_iterator(more.end()));
+}
+
+// Channel state queries, parseChannelState reads their answers in the same order
+
+void appendPathQueries(std::vector<std::string>& messages, uint16_t slotId, fesd::SC2470::Path path, const fesd::SC2470Processor::PathQuery& query)
+{
+    using fesd::MessageBuilder;
+    if (query.frequencies)
+        messages.push_back(MessageBuilder::buildQuery(pathFreq, slotId, path));
+    if (query.gainLimits)
+        messages.push_back(MessageBuilder::buildQuery(pathGainLim, slotId, path));
+    if (query.gain)
+        messages.push_back(MessageBuilder::buildQuery(pathGain, slotId, path));
+    if (query.attenuation && path == fesd::SC2470::Path::TX)
+        messages.push_back(MessageBuilder::buildQuery(rfPathAttn, slotId, path));
+    if (query.attenuation && path == fesd::SC2470::Path::RX)
+        messages.push_back(MessageBuilder::buildQuery(ifPathAttn, slotId, path));
+    if (query.synthOutput)
+    {
+        messages.push_back(MessageBuilder::buildQuery(synthPower, slotId, path));
+        messages.push_back(MessageBuilder::buildQuery(synthEnable, slotId, path));
+    }
+    if (query.loEnable)
+        messages.push_back(MessageBuilder::buildQuery(loClkEn, slotId, path));
+    if (query.synthReference)
+    {
+        messages.push_back(MessageBuilder::buildQuery(synthRefAuto, slotId, path));
+        messages.push_back(MessageBuilder::buildQuery(synthRefFreq, slotId, path));
+    }
+    if (query.phase)
+    {
+        messages.push_back(MessageBuilder::buildQuery(synthFractionalMode, slotId, path));
+        messages.push_back(MessageBuilder::buildQuery(phaseAccumulator, slotId, path));
+    }
+    if (query.dcBias)
+        messages.push_back(MessageBuilder::buildQuery(ifPathDCBias, slotId, path));
+}
+
+std::vector<std::string> channelQueries(uint16_t slotId, const fesd::SC2470Processor::ChannelQuery& query)
+{
+    using fesd::MessageBuilder;
+    std::vector<std::string> messages;
+    if (query.duplex)
+    {
+        messages.push_back(MessageBuilder::buildQuery(rfPathPath, slotId));
+        messages.push_back(MessageBuilder::buildQuery(rfPathTdd, slotId));
+    }
+    if (query.reference)
+        messages.push_back(MessageBuilder::buildQuery(refConfig, slotId));
+    if (query.referenceOutput)
+        messages.push_back(MessageBuilder::buildQuery(refOutputEnable, slotId));
+    appendPathQueries(messages, slotId, fesd::SC2470::Path::RX, query.rx);
+    appendPathQueries(messages, slotId, fesd::SC2470::Path::TX, query.tx);
+    return messages;
+}
+
+// Answers to the channel state queries in order, a query the device failed throws
+class ChannelAnswers final
+{
+public:
+    ChannelAnswers(const fesd::TransactionResults& results, std::size_t first = 0) : m_results(results), m_next(first) {}
+
+    const std::string& next(void)
+    {
+        if (m_next >= m_results.size())
+            throwCommsError();
+        return m_results[m_next++].value();
+    }
+
+private:
+    const fesd::TransactionResults& m_results;
+    std::size_t m_next;
+};
+
+bool parseFlag(std::string_view result)
+{
+    if (result == "0") return false;
+    else if (result == "1") return true;
+    throwCommsError();
+    // Never gets here, this is to fix warning
+    return false;
+}
+
+fesd::SC2470Processor::PathState parsePathState(ChannelAnswers& answers, fesd::SC2470::Path path, const fesd::SC2470Processor::PathQuery& query)
+{
+    fesd::SC2470Processor::PathState state;
+    if (query.frequencies)
+        state.frequencies = parseFrequencies(answers.next());
+    if (query.gainLimits)
+        state.gainLimits = parseGainLimits(answers.next());
+    if (query.gain)
+        state.gainDb = fesd::ResponseParser::value<double>(answers.next());
+    if (query.attenuation && path == fesd::SC2470::Path::TX)
+        state.attnTxDb = fesd::ResponseParser::value<double>(answers.next());
+    if (query.attenuation && path == fesd::SC2470::Path::RX)
+        state.attnRx = parseAttnRx(answers.next());
+    if (query.synthOutput)
+    {
+        const fesd::SC2470Processor::SynthesizerPowerSet power = parseSynthPowerLevel(answers.next());
+        state.synthOutput = {power, parseSynthEnable(answers.next())};
+    }
+    if (query.loEnable)
+        state.loEnable = parseEnable(answers.next());
+    if (query.synthReference)
+    {
+        const bool automatic = parseSynthReferenceAuto(answers.next());
+        state.synthReference = {automatic, parseSynthReferenceFrequency(answers.next())};
+    }
+    if (query.phase)
+    {
+        state.forceFractional = parseFlag(answers.next());
+        state.phase = fesd::ResponseParser::value<double>(answers.next());
+    }
+    if (query.dcBias)
+        state.dcBias = parseDCBias(answers.next());
+    return state;
+}
+
+fesd::SC2470Processor::ChannelState parseChannelState(ChannelAnswers& answers, const fesd::SC2470Processor::ChannelQuery& query)
+{
+    fesd::SC2470Processor::ChannelState state;
+    if (query.duplex)
+    {
+        const fesd::SC2470Processor::DuplexSetting rfPath = parseRfPath(answers.next());
+        state.duplex = {rfPath, parseTddPath(answers.next())};
+    }
+    if (query.reference)
+        state.reference = parseReferenceConfig(answers.next());
+    if (query.referenceOutput)
+        state.referenceOutput = parseEnable(answers.next());
+    state.rx = parsePathState(answers, fesd::SC2470::Path::RX, query.rx);
+    state.tx = parsePathState(answers, fesd::SC2470::Path::TX, query.tx);
+    return state;
+}
+
+// Channel state commands in the order the settings are listed in, retunes come before the settings that depend on them
+
+void appendPathCommands(std::vector<std::string>& messages, uint16_t slotId, fesd::SC2470::Path path, const fesd::SC2470Processor::PathState& state)
+{
+    using fesd::MessageBuilder;
+    if (state.synthReference)
+    {
+        const bool automatic = state.synthReference->automatic;
+        append(messages, synthReferenceStateCommands(slotId, path, automatic, automatic ? std::nullopt : std::optional(state.synthReference->freq)));
+    }
+    if (state.forceFractional)
+        messages.push_back(MessageBuilder::buildCommand(synthFractionalMode, slotId, path, {*state.forceFractional}));
+    if (state.frequencies)
+        messages.push_back(MessageBuilder::buildCommand(pathFreq, slotId, path, {state.frequencies->rfKHz, state.frequencies->ifKHz, state.frequencies->loKHz}));
+    if (state.loKHz)
+        messages.push_back(MessageBuilder::buildCommand(loClkFreq, slotId, path, {*state.loKHz}));
+    if (state.phaseIncrement)
+        messages.push_back(MessageBuilder::buildCommand(phaseIncrement, slotId, path, {*state.phaseIncrement}));
+    if (state.gainDb)
+        messages.push_back(MessageBuilder::buildCommand(pathGain, slotId, path, {*state.gainDb}));
+    if (state.attnTxDb)
+        messages.push_back(MessageBuilder::buildCommand(rfPathAttn, slotId, fesd::SC2470::Path::TX, {*state.attnTxDb}));
+    if (state.attnRx)
+        messages.push_back(MessageBuilder::buildCommand(ifPathAttn, slotId, fesd::SC2470::Path::RX, {state.attnRx->attnADb, state.attnRx->attnBDb}));
+    if (state.synthOutput)
+        append(messages, synthOutputCommands(slotId, path, *state.synthOutput));
+    if (state.loEnable)
+        messages.push_back(MessageBuilder::buildCommand(loClkEn, slotId, path, {fesd::utility::at(EnableStringMap, *state.loEnable)}));
+    if (state.dcBias)
+        messages.push_back(MessageBuilder::buildCommand(ifPathDCBias, slotId, path, {state.dcBias->i, state.dcBias->q}));
+}
+
+std::vector<std::string> channelCommands(uint16_t slotId, const fesd::SC2470Processor::ChannelState& state)
+{
+    std::vector<std::string> messages;
+    if (state.duplex)
+    {
+        const bool tdd = state.duplex->rfPath == fesd::SC2470Processor::DuplexSetting::TDD;
+        append(messages, duplexStateCommands(slotId, state.duplex->rfPath, tdd ? std::optional(state.duplex->tddPath) : std::nullopt));
+    }
+    if (state.reference)
+        messages.push_back(buildReferenceConfigCommand(slotId, *state.reference));
+    appendPathCommands(messages, slotId, fesd::SC2470::Path::RX, state.rx);
+    appendPathCommands(messages, slotId, fesd::SC2470::Path::TX, state.tx);
+    if (state.referenceOutput)
+        messages.push_back(fesd::MessageBuilder::buildCommand(refOutputEnable, slotId, {fesd::utility::at(EnableStringMap, *state.referenceOutput)}));
+    if (state.apply && !messages.empty())
+        messages.push_back(fesd::MessageBuilder::buildCommand(configApply, slotId));
+    return messages;
+}
+
 } // namespace
 
 namespace fesd {
 
 double SC2470Processor::getAttnTx(void) const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(rfPathAttn, m_details->slotId, SC2470::Path::TX)));
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(rfPathAttn, m_details->slotId, SC2470::Path::TX)));
 }
 
 void SC2470Processor::setAttnTx(double attnDb) const
 {
-    const std::vector<std::string> params{std::to_string(attnDb)};
+    const MessageBuilder::Params params{attnDb};
     m_details->connection->transact(MessageBuilder::buildCommand(rfPathAttn, m_details->slotId, SC2470::Path::TX, params));
 }
 
 SC2470Processor::GainLimitsSet SC2470Processor::getGainLimits(SC2470::Path path) const
 {
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(pathGainLim, m_details->slotId, path));
-    std::vector<std::string> splitResult;
-
-    boost::split(splitResult, result, boost::is_any_of(" "));
-
-    return {std::stod(splitResult[0]), std::stod(splitResult[1])};
+    return parseGainLimits(m_details->connection->transact(MessageBuilder::buildQuery(pathGainLim, m_details->slotId, path)));
 }
 
 double SC2470Processor::getGain(SC2470::Path path) const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(pathGain, m_details->slotId, path)));
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(pathGain, m_details->slotId, path)));
 }
 
 void SC2470Processor::setGain(SC2470::Path path, double gainDb) const
 {
-    std::vector<std::string> params{std::to_string(gainDb)};
+    const MessageBuilder::Params params{gainDb};
     m_details->connection->transact(MessageBuilder::buildCommand(pathGain, m_details->slotId, path, params));
 }
 
 
 SC2470Processor::AttenuatorRxSet SC2470Processor::getAttnRx(void) const
 {
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(ifPathAttn, m_details->slotId, SC2470::Path::RX));
-    std::vector<std::string> splitResult;
-
-    boost::split(splitResult, result, boost::is_any_of(" "));
-
-    return {std::stod(splitResult[0]), std::stod(splitResult[1])};
+    return parseAttnRx(m_details->connection->transact(MessageBuilder::buildQuery(ifPathAttn, m_details->slotId, SC2470::Path::RX)));
 }
 
 void SC2470Processor::setAttnRx(SC2470Processor::AttenuatorRxSet attns) const
 {
-    const std::vector<std::string> params{std::to_string(attns.attnADb), std::to_string(attns.attnBDb)};
+    const MessageBuilder::Params params{attns.attnADb, attns.attnBDb};
     m_details->connection->transact(MessageBuilder::buildCommand(ifPathAttn, m_details->slotId, SC2470::Path::RX, params));
 }
 
 SC2470Processor::DuplexSetting SC2470Processor::getRfPath(void) const
 {
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(rfPathPath, m_details->slotId));
-
-    for (const auto& [key, value] : DuplexStringMap)
-    {
-        if (result.substr(0, 3).compare(value) == 0) return key;
-    }
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return SC2470Processor::DuplexSetting::FDD;
+    return parseRfPath(m_details->connection->transact(MessageBuilder::buildQuery(rfPathPath, m_details->slotId)));
 }
 
 void SC2470Processor::setRfPath(SC2470Processor::DuplexSetting duplex) const
 {
-    const std::vector<std::string> params{DuplexStringMap.at(duplex)};
+    const MessageBuilder::Params params{fesd::utility::at(DuplexStringMap, duplex)};
     m_details->connection->transact(MessageBuilder::buildCommand(rfPathPath, m_details->slotId, params));
 }
 
 SC2470::Path SC2470Processor::getTddPath(void) const
 {
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(rfPathTdd, m_details->slotId));
-
-    for (const auto& [key, value] : PathStringMap)
-    {
-        if (result.compare(value) == 0) return key;
-    }
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return SC2470::Path::RX;
+    return parseTddPath(m_details->connection->transact(MessageBuilder::buildQuery(rfPathTdd, m_details->slotId)));
 }
 
 void SC2470Processor::setTddPath(SC2470::Path setting) const
@@ -182,224 +546,168 @@ void SC2470Processor::setTddPath(SC2470::Path setting) const
 
 SC2470Processor::SynthesizerPowerSet SC2470Processor::getSynthPowerLevel(SC2470::Path path) const
 {
-    SC2470Processor::SynthesizerPowerSet resultSet;
-    std::vector<std::string> splitResult;
-
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(synthPower, m_details->slotId, path));
-
-    boost::split(splitResult, result, boost::is_any_of(" "));
-
-    resultSet.power1x = std::stoul(splitResult[0]);
-    resultSet.power2x = std::stoul(splitResult[1]);
-
-    return resultSet;
+    return parseSynthPowerLevel(m_details->connection->transact(MessageBuilder::buildQuery(synthPower, m_details->slotId, path)));
 }
 
 void SC2470Processor::setSynthPowerLevel(SC2470::Path path, SC2470Processor::SynthesizerPowerSet powerSet) const
 {
-    std::vector<std::string> params{std::to_string(powerSet.power1x), std::to_string(powerSet.power2x)};
+    const MessageBuilder::Params params{powerSet.power1x, powerSet.power2x};
     m_details->connection->transact(MessageBuilder::buildCommand(synthPower, m_details->slotId, path, params));
 }
 
 SC2470Processor::SynthsizerReferenceFreq SC2470Processor::getSynthReferenceFrequency(SC2470::Path path) const
 {
-    const double result = std::stod(m_details->connection->transact(MessageBuilder::buildQuery(synthRefFreq, m_details->slotId, path)));
-
-    for (const auto& [key, value] : SynthReferenceFreqKhzMap)
-    {
-        if (utility::isAlmostEqual(result, value)) return key;
-    }
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return SC2470Processor::SynthsizerReferenceFreq::Freq100MHz;
+    return parseSynthReferenceFrequency(m_details->connection->transact(MessageBuilder::buildQuery(synthRefFreq, m_details->slotId, path)));
 }
 
 void SC2470Processor::setSynthReferenceFrequency(SC2470::Path path, SC2470Processor::SynthsizerReferenceFreq freq) const
 {
-    const std::vector<std::string> params({std::to_string(SynthReferenceFreqKhzMap.at(freq))});
+    const MessageBuilder::Params params{fesd::utility::at(SynthReferenceFreqKhzMap, freq)};
     m_details->connection->transact(MessageBuilder::buildCommand(synthRefFreq, m_details->slotId, path, params));
 }
 
 bool SC2470Processor::getSynthReferenceAuto(SC2470::Path path) const {
-    std::string result = m_details->connection->transact(MessageBuilder::buildQuery(synthRefAuto, m_details->slotId, path));
-
-    if (result == "0") return false;
-    else if (result == "1") return true;
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return false;
+    return parseSynthReferenceAuto(m_details->connection->transact(MessageBuilder::buildQuery(synthRefAuto, m_details->slotId, path)));
 }
 
 void SC2470Processor::setSynthReferenceAuto(SC2470::Path path, bool enable) const {
-    std::vector<std::string> params{enable ? "1" : "0"};
+    const MessageBuilder::Params params{enable};
     m_details->connection->transact(MessageBuilder::buildCommand(synthRefAuto, m_details->slotId, path, params));
 }
 
 SC2470Processor::FrequencySet SC2470Processor::getFrequencies(SC2470::Path path) const
 {
-    SC2470Processor::FrequencySet resultSet;
-    std::vector<std::string> splitResult;
-
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(pathFreq, m_details->slotId, path));
-
-    boost::split(splitResult, result, boost::is_any_of(" "));
-
-    resultSet.rfKHz = std::stod(splitResult[0]);
-    resultSet.ifKHz = std::stod(splitResult[1]);
-    resultSet.loKHz = std::stod(splitResult[2]);
-
-    return resultSet;
+    return parseFrequencies(m_details->connection->transact(MessageBuilder::buildQuery(pathFreq, m_details->slotId, path)));
 }
 
 void SC2470Processor::setFrequencies(SC2470::Path path, SC2470Processor::FrequencySet freqs) const
 {
-    const std::vector<std::string> params{std::to_string(freqs.rfKHz), std::to_string(freqs.ifKHz), std::to_string(freqs.loKHz)};
+    const MessageBuilder::Params params{freqs.rfKHz, freqs.ifKHz, freqs.loKHz};
     m_details->connection->transact(MessageBuilder::buildCommand(pathFreq, m_details->slotId, path, params));
 }
 
 void SC2470Processor::setBypassFrequency(SC2470::Path path, double freq) const
 {
-    const std::vector<std::string> params{std::to_string(freq), std::to_string(freq), std::to_string(0.0)};
+    const MessageBuilder::Params params{freq, freq, 0.0};
     m_details->connection->transact(MessageBuilder::buildCommand(pathFreq, m_details->slotId, path, params));
 }
 
 double SC2470Processor::getLoFrequencyKHz(SC2470::Path path) const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(loClkFreq, m_details->slotId, path)));
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(loClkFreq, m_details->slotId, path)));
 }
 
 void SC2470Processor::setLoFrequencyKHz(SC2470::Path path, double frequencyKhz) const
 {
-    std::vector<std::string> params{std::to_string(frequencyKhz)};
+    const MessageBuilder::Params params{frequencyKhz};
     m_details->connection->transact(MessageBuilder::buildCommand(loClkFreq, m_details->slotId, path, params));
 }
 /*
 double SC2470Processor::getPaBiasCurrent(uint16_t paId) const
 {
-    std::vector<std::string> params{std::to_string(paId)};
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(paBiasCurrent, m_details->slotId, params)));
+    const MessageBuilder::Params params{paId};
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(paBiasCurrent, m_details->slotId, params)));
 }
 
 void SC2470Processor::setPaBiasCurrent(uint16_t paId, double currentSetpoint) const
 {
-    std::vector<std::string> params{std::to_string(paId), std::to_string(currentSetpoint)};
+    const MessageBuilder::Params params{paId, currentSetpoint};
     m_details->connection->transact(MessageBuilder::buildCommand(paBiasCurrent, m_details->slotId, params));
 }
 
 double SC2470Processor::getPaBiasVoltage(uint16_t paId) const
 {
-    std::vector<std::string> params{std::to_string(paId)};
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(paBiasVolt, m_details->slotId, params)));
+    const MessageBuilder::Params params{paId};
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(paBiasVolt, m_details->slotId, params)));
 }
 */
 double SC2470Processor::getPaDrainVoltage(uint16_t paId) const
 {
-    std::vector<std::string> params{std::to_string(paId)};
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(paDrainVolt, m_details->slotId, params)));
+    const MessageBuilder::Params params{paId};
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(paDrainVolt, m_details->slotId, params), std::nullopt, CommandPriority::Telemetry));
 }
 
 double SC2470Processor::getPaTemp() const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(paBiasTemp, m_details->slotId)));
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(paBiasTemp, m_details->slotId), std::nullopt, CommandPriority::Telemetry));
 }
 
 double SC2470Processor::getReferenceDac() const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(refDac, m_details->slotId)));
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(refDac, m_details->slotId)));
 }
 
 void SC2470Processor::setReferenceDac(uint32_t dacValue) const
 {
-    std::stringstream ss;
-    ss << "0x" << std::hex << dacValue;
-    std::string formatedValue = ss.str();
-    std::vector<std::string> params{formatedValue};
+    const MessageBuilder::Params params{MessageParam::hex(dacValue)};
     m_details->connection->transact(MessageBuilder::buildCommand(refDac, m_details->slotId, params));
 }
 
 SC2470Processor::ReferenceConfig SC2470Processor::getReferenceConfig() const
 {
-    SC2470Processor::ReferenceConfig returnValues;
-    std::vector<std::string> splitResult;
-    bool setFlag = false;
-
-    std::string result = m_details->connection->transact(MessageBuilder::buildQuery(refConfig, m_details->slotId));
-
-    boost::split(splitResult, result, boost::is_any_of(" "));
-
-    if (splitResult.size() < 2) throwCommsError();
+    return parseReferenceConfig(m_details->connection->transact(MessageBuilder::buildQuery(refConfig, m_details->slotId)));
+}
 
-    setFlag = false;
-    for (const auto& [key, value] : ClockSourceStringMap)
-    {
-        // first string should be clock source
-        if (splitResult[0].compare(value) == 0)
-        {
-            returnValues.clkSource = key;
-            setFlag = true;
-            break;
-        }
-    }
+void SC2470Processor::setReferenceConfig(const SC2470Processor::ReferenceConfig& config) const
+{
+    m_details->connection->transact(buildReferenceConfigCommand(m_details->slotId, config));
+}
 
-    if (!setFlag) throwCommsError();
+double SC2470Processor::getReferenceLockDetect() const
+{
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(refLockDetect, m_details->slotId), std::nullopt, CommandPriority::Telemetry));
+    // TODO Come back to this, am i returning 1 or 2 values
+}
 
-    setFlag = false;
-    for (const auto& [key, value] : ReferenceFreqKhzMap)
+std::optional<std::chrono::nanoseconds> SC2470Processor::pollReferenceLock(std::chrono::steady_clock::time_point since, std::chrono::steady_clock::time_point until) const
+{
+    // A lock wait is part of the retune, so unlike getReferenceLockDetect its polls do not queue behind telemetry.
+    // Polls hold up the other traffic on the port, a device that is slow to settle is polled less often.
+    const std::string query = MessageBuilder::buildQuery(refLockDetect, m_details->slotId);
+    const auto locked = [this, &query]() { return ResponseParser::value<double>(m_details->connection->transact(query, std::nullopt, CommandPriority::Control)) != 0.0; };
+    std::chrono::nanoseconds interval = std::clamp<std::chrono::nanoseconds>(m_details->settle->median() / 8, MinLockPollInterval, MaxLockPollInterval);
+    while (!locked())
     {
-        // second string should be frequency
-        if (utility::isAlmostEqual(std::stod(splitResult[1]), value))
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= until)
         {
-            returnValues.freqSel = key;
-            setFlag = true;
-            break;
+            m_details->settle->recordTimeout();
+            return std::nullopt;
         }
+        std::this_thread::sleep_until(std::min(now + interval, until));
+        interval = std::min<std::chrono::nanoseconds>(interval * 2, MaxLockPollInterval);
     }
-
-    if (!setFlag) throwCommsError();
-
-    return returnValues;
+    const std::chrono::nanoseconds settled = std::chrono::steady_clock::now() - since;
+    m_details->settle->record(settled);
+    return settled;
 }
 
-void SC2470Processor::setReferenceConfig(const SC2470Processor::ReferenceConfig& config) const
+std::chrono::nanoseconds SC2470Processor::waitForReferenceLock(std::chrono::steady_clock::time_point since) const
 {
-    std::vector<std::string> params{ClockSourceStringMap.at(config.clkSource)};
-    double frequencyKhz;
-
-    // Clock must be 100000 when clock sournce is Internal
-    if (config.clkSource == SC2470Processor::ClockSource::Internal) frequencyKhz = ReferenceFreqKhzMap.at(SC2470Processor::ReferenceFreq::Freq100MHz);
-    else frequencyKhz = ReferenceFreqKhzMap.at(config.freqSel);
-    params.push_back(std::to_string(frequencyKhz));
+    const std::optional<std::chrono::nanoseconds> settled = pollReferenceLock(since, since + m_details->connection->getCommandTimeouts().retune);
+    if (!settled.has_value())
+        throw CommunicationError("Reference PLL did not lock");
+    return settled.value();
+}
 
-    m_details->connection->transact(MessageBuilder::buildCommand(refConfig, m_details->slotId, params));
+SettleStats SC2470Processor::getSettleStats() const
+{
+    return m_details->settle->get();
 }
 
-double SC2470Processor::getReferenceLockDetect() const
+void SC2470Processor::resetSettleStats() const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(refLockDetect, m_details->slotId)));
-    // TODO Come back to this, am i returning 1 or 2 values
+    m_details->settle->reset();
 }
 
 bool SC2470Processor::getReferenceOutputEnable() const
 {
-    std::string result = m_details->connection->transact(MessageBuilder::buildQuery(refOutputEnable, m_details->slotId));
-
-    for (const auto& [key, value] : EnableStringMap)
-    {
-        if (result.compare(value) == 0)
-        {
-            return key;
-        }
-    }
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return false;
+    return parseEnable(m_details->connection->transact(MessageBuilder::buildQuery(refOutputEnable, m_details->slotId)));
 }
 
 void SC2470Processor::setReferenceOutputEnable(bool enable) const
 {
-    std::vector<std::string> params{EnableStringMap.at(enable)};
+    const MessageBuilder::Params params{fesd::utility::at(EnableStringMap, enable)};
     m_details->connection->transact(MessageBuilder::buildCommand(refOutputEnable, m_details->slotId, params));
 }
 
@@ -417,68 +725,51 @@ bool SC2470Processor::getForceFractionalMode(SC2470::Path path) const
 
 void SC2470Processor::setForceFractionalMode(SC2470::Path path, bool enable) const
 {
-    std::vector<std::string> params{};
-    if (enable) params.push_back("1");
-    else params.push_back("0");
+    const MessageBuilder::Params params{enable};
     m_details->connection->transact(MessageBuilder::buildCommand(synthFractionalMode, m_details->slotId, path, params));
 }
 
 void SC2470Processor::incrementPhase(SC2470::Path path, double increment) const
 {
-    std::vector<std::string> params{std::to_string(increment)};
+    const MessageBuilder::Params params{increment};
     m_details->connection->transact(MessageBuilder::buildCommand(phaseIncrement, m_details->slotId, path, params));
 }
 
 double SC2470Processor::getPhaseAccumulator(SC2470::Path path) const
 {
-    return std::stod(m_details->connection->transact(MessageBuilder::buildQuery(phaseAccumulator, m_details->slotId, path)));
+    return ResponseParser::value<double>(m_details->connection->transact(MessageBuilder::buildQuery(phaseAccumulator, m_details->slotId, path)));
 }
 
 void SC2470Processor::setPhaseAccumulator(SC2470::Path path, double phase) const
 {
-    std::vector<std::string> params{std::to_string(phase)};
+    const MessageBuilder::Params params{phase};
     m_details->connection->transact(MessageBuilder::buildCommand(phaseAccumulator, m_details->slotId, path, params));
 }
 
 SC2470Processor::SynthesizerEnableSet SC2470Processor::getSynthEnable(SC2470::Path path) const
 {
-    std::vector<std::string> splitResult;
-    std::string result = m_details->connection->transact(MessageBuilder::buildQuery(synthEnable, m_details->slotId, path));
-    boost::split(splitResult, result, boost::is_any_of(" "));
-
-    if (splitResult.size() == 2)
-        return {(splitResult.at(0).compare(EnableStringMap.at(true)) == 0), (splitResult.at(1).compare(EnableStringMap.at(true)) == 0)};
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return {false, false};
+    return parseSynthEnable(m_details->connection->transact(MessageBuilder::buildQuery(synthEnable, m_details->slotId, path)));
 }
 
 void SC2470Processor::setSynthEnable(SC2470::Path path, SC2470Processor::SynthesizerEnableSet enables) const
 {
-    std::vector<std::string> params{EnableStringMap.at(enables.enable1x), EnableStringMap.at(enables.enable2x)};
+    const MessageBuilder::Params params{fesd::utility::at(EnableStringMap, enables.enable1x), fesd::utility::at(EnableStringMap, enables.enable2x)};
     m_details->connection->transact(MessageBuilder::buildCommand(synthEnable, m_details->slotId, path, params));
 }
 
 SC2470Processor::SynthesizerRfRegisters SC2470Processor::getSynthRfSet(SC2470::Path path) const
 {
     SynthesizerRfRegisters result;
-    std::vector<std::string> splitResult;
-    std::string response = m_details->connection->transact(MessageBuilder::buildQuery(synthRfSet, m_details->slotId, path));
-    boost::split(splitResult, response, boost::is_any_of(" "));
-
-    if (splitResult.size() == 5)
-    {
-        result.intDivider = std::stoi(splitResult.at(0));
-        result.frac1 = std::stoul(splitResult.at(1));
-        result.frac2 = std::stoul(splitResult.at(2));
-        result.mod2 = std::stoul(splitResult.at(3));
-        result.rfDivider = std::stoi(splitResult.at(4));
-        return result;
-    }
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
+    const std::string response = m_details->connection->transact(MessageBuilder::buildQuery(synthRfSet, m_details->slotId, path));
+    ResponseParser parser(response);
+
+    result.intDivider = parser.next<uint16_t>();
+    result.frac1 = parser.next<uint32_t>();
+    result.frac2 = parser.next<uint32_t>();
+    result.mod2 = parser.next<uint32_t>();
+    result.rfDivider = parser.next<uint16_t>();
+    if (!parser.done())
+        throwCommsError();
     return result;
 }
 
@@ -516,10 +807,7 @@ bool SC2470Processor::getConfigAutoload(void) const
 
 void SC2470Processor::setConfigAutoload(bool enable) const
 {
-    std::vector<std::string> params{};
-
-    if (enable) params.push_back("1");
-    else params.push_back("0");
+    const MessageBuilder::Params params{enable};
 
     m_details->connection->transact(MessageBuilder::buildCommand(configAutoLoad, m_details->slotId, params));
 }
@@ -538,49 +826,407 @@ bool SC2470Processor::getConfigAutoPhase(void) const
 
 void SC2470Processor::setConfigAutoPhase(bool enable) const
 {
-    std::vector<std::string> params{};
-
-    if (enable) params.push_back("1");
-    else params.push_back("0");
+    const MessageBuilder::Params params{enable};
 
     m_details->connection->transact(MessageBuilder::buildCommand(configAutoPhase, m_details->slotId, params));
 }
 
 bool SC2470Processor::getLoClkEnable(SC2470::Path path) const
 {
-    std::string result = m_details->connection->transact(MessageBuilder::buildQuery(loClkEn, m_details->slotId, path));
-
-    if (result.compare(EnableStringMap.at(true)) == 0) return true;
-    else if (result.compare(EnableStringMap.at(false)) == 0) return false;
-
-    throwCommsError();
-    // Never gets here, this is to fix warning
-    return false;
+    return parseEnable(m_details->connection->transact(MessageBuilder::buildQuery(loClkEn, m_details->slotId, path)));
 }
 
 void SC2470Processor::setLoClkEnable(SC2470::Path path, bool enable) const
 {
-    std::vector<std::string> params{EnableStringMap.at(enable)};
+    const MessageBuilder::Params params{fesd::utility::at(EnableStringMap, enable)};
     m_details->connection->transact(MessageBuilder::buildCommand(loClkEn, m_details->slotId, path, params));
 }
 
 void SC2470Processor::setDCBias(SC2470::Path path, SC2470::DCBias bias) const {
-    const std::vector<std::string> params{std::to_string(bias.i), std::to_string(bias.q)};
+    const MessageBuilder::Params params{bias.i, bias.q};
     m_details->connection->transact(MessageBuilder::buildCommand(ifPathDCBias, m_details->slotId, path, params));
 }
 
 SC2470::DCBias SC2470Processor::getDCBias(SC2470::Path path) const {
-    SC2470::DCBias resultBias;
-    std::vector<std::string> splitResult;
+    return parseDCBias(m_details->connection->transact(MessageBuilder::buildQuery(ifPathDCBias, m_details->slotId, path)));
+}
+
+SC2470Processor::SynthesizerOutputSet SC2470Processor::getSynthOutput(SC2470::Path path) const
+{
+    const TransactionResults results = m_details->connection->transact({
+        MessageBuilder::buildQuery(synthPower, m_details->slotId, path),
+        MessageBuilder::buildQuery(synthEnable, m_details->slotId, path),
+    });
+
+    return {parseSynthPowerLevel(results[0].value()), parseSynthEnable(results[1].value())};
+}
+
+SC2470Processor::SynthesizerOutputSet SC2470Processor::setSynthOutput(SC2470::Path path, const SC2470Processor::SynthesizerOutputSet& settings) const
+{
+    std::vector<std::string> messages = synthOutputCommands(m_details->slotId, path, settings);
+    messages.push_back(MessageBuilder::buildQuery(synthPower, m_details->slotId, path));
+    messages.push_back(MessageBuilder::buildQuery(synthEnable, m_details->slotId, path));
+
+    const TransactionResults results = m_details->connection->transact(messages);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    return {parseSynthPowerLevel(results[2].response), parseSynthEnable(results[3].response)};
+}
+
+void SC2470Processor::writeSynthOutput(SC2470::Path path, const SC2470Processor::SynthesizerOutputSet& settings) const
+{
+    transactCommands(*m_details->connection, synthOutputCommands(m_details->slotId, path, settings));
+}
 
-    const std::string result = m_details->connection->transact(MessageBuilder::buildQuery(ifPathDCBias, m_details->slotId, path));
+SC2470Processor::DuplexState SC2470Processor::getDuplexState(void) const
+{
+    const TransactionResults results = m_details->connection->transact({
+        MessageBuilder::buildQuery(rfPathPath, m_details->slotId),
+        MessageBuilder::buildQuery(rfPathTdd, m_details->slotId),
+    });
+
+    return {parseRfPath(results[0].value()), parseTddPath(results[1].value())};
+}
 
-    boost::split(splitResult, result, boost::is_any_of(" "));
+SC2470Processor::DuplexState SC2470Processor::setDuplexState(SC2470Processor::DuplexSetting duplex, std::optional<SC2470::Path> tddPath) const
+{
+    std::vector<std::string> messages = duplexStateCommands(m_details->slotId, duplex, tddPath);
+    messages.push_back(MessageBuilder::buildQuery(rfPathPath, m_details->slotId));
+    messages.push_back(MessageBuilder::buildQuery(rfPathTdd, m_details->slotId));
+
+    const TransactionResults results = m_details->connection->transact(messages);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    return {parseRfPath(results[results.size() - 2].response), parseTddPath(results.back().response)};
+}
 
-    resultBias.i = std::stoi(splitResult[0]);
-    resultBias.q = std::stoi(splitResult[1]);
+void SC2470Processor::writeDuplexState(SC2470Processor::DuplexSetting duplex, std::optional<SC2470::Path> tddPath) const
+{
+    transactCommands(*m_details->connection, duplexStateCommands(m_details->slotId, duplex, tddPath));
+}
+
+SC2470Processor::SynthesizerReferenceState SC2470Processor::getSynthReferenceState(SC2470::Path path) const
+{
+    const TransactionResults results = m_details->connection->transact({
+        MessageBuilder::buildQuery(synthRefAuto, m_details->slotId, path),
+        MessageBuilder::buildQuery(synthRefFreq, m_details->slotId, path),
+    });
+
+    return {parseSynthReferenceAuto(results[0].value()), parseSynthReferenceFrequency(results[1].value())};
+}
 
-    return resultBias;
+SC2470Processor::SynthesizerReferenceState SC2470Processor::setSynthReferenceState(SC2470::Path path, bool automatic, std::optional<SC2470Processor::SynthsizerReferenceFreq> freq) const
+{
+    std::vector<std::string> messages = synthReferenceStateCommands(m_details->slotId, path, automatic, freq);
+    messages.push_back(MessageBuilder::buildQuery(synthRefAuto, m_details->slotId, path));
+    messages.push_back(MessageBuilder::buildQuery(synthRefFreq, m_details->slotId, path));
+
+    const TransactionResults results = m_details->connection->transact(messages);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    return {parseSynthReferenceAuto(results[results.size() - 2].response), parseSynthReferenceFrequency(results.back().response)};
+}
+
+void SC2470Processor::writeSynthReferenceState(SC2470::Path path, bool automatic, std::optional<SC2470Processor::SynthsizerReferenceFreq> freq) const
+{
+    transactCommands(*m_details->connection, synthReferenceStateCommands(m_details->slotId, path, automatic, freq));
+}
+
+SC2470Processor::LoFrequencySet SC2470Processor::getLoFrequenciesKHz(void) const
+{
+    const TransactionResults results = m_details->connection->transact({
+        MessageBuilder::buildQuery(loClkFreq, m_details->slotId, SC2470::Path::RX),
+        MessageBuilder::buildQuery(loClkFreq, m_details->slotId, SC2470::Path::TX),
+    });
+
+    return {ResponseParser::value<double>(results[0].value()), ResponseParser::value<double>(results[1].value())};
+}
+
+SC2470Processor::ReferenceSwitch SC2470Processor::switchReference(const SC2470Processor::ReferenceConfig& config, SC2470Processor::LoFrequencySet loKHz, bool readback) const
+{
+    std::vector<std::string> messages = referenceConfigAndLoCommands(m_details->slotId, config, loKHz);
+    if (readback)
+        messages.push_back(MessageBuilder::buildQuery(refConfig, m_details->slotId));
+    messages.push_back(MessageBuilder::buildQuery(refLockDetect, m_details->slotId));
+
+    const auto start = std::chrono::steady_clock::now();
+    const TransactionResults results = m_details->connection->transact(messages);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    ReferenceSwitch result{};
+    if (readback)
+        result.readback = parseReferenceConfig(results[results.size() - 2].response);
+    // A reference that locked while the LOs were re-applied needs no further poll
+    if (ResponseParser::value<double>(results.back().response) != 0.0)
+    {
+        result.timeToLock = std::chrono::steady_clock::now() - start;
+        m_details->settle->record(result.timeToLock);
+    }
+    else
+        result.timeToLock = waitForReferenceLock(start);
+    return result;
+}
+
+SC2470Processor::ChannelState SC2470Processor::getChannelState(const SC2470Processor::ChannelQuery& query) const
+{
+    const std::vector<std::string> messages = channelQueries(m_details->slotId, query);
+    if (messages.empty())
+        return {};
+
+    const TransactionResults results = m_details->connection->transact(messages);
+    ChannelAnswers answers(results);
+    return parseChannelState(answers, query);
+}
+
+SC2470Processor::ChannelState SC2470Processor::writeChannelState(const SC2470Processor::ChannelState& state, const SC2470Processor::ChannelQuery& readback) const
+{
+    std::vector<std::string> messages = channelCommands(m_details->slotId, state);
+    const std::size_t commands = messages.size();
+    append(messages, channelQueries(m_details->slotId, readback));
+    if (messages.empty())
+        return {};
+
+    const TransactionResults results = m_details->connection->transact(messages);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    ChannelAnswers answers(results, commands);
+    return parseChannelState(answers, readback);
+}
+
+std::string SC2470Processor::encodeFrequencies(SC2470::Path path, const SC2470Processor::FrequencySet& freqsKHz) const
+{
+    return MessageBuilder::buildCommand(pathFreq, m_details->slotId, path, {freqsKHz.rfKHz, freqsKHz.ifKHz, freqsKHz.loKHz});
+}
+
+std::string SC2470Processor::encodeGain(SC2470::Path path, double gainDb) const
+{
+    return MessageBuilder::buildCommand(pathGain, m_details->slotId, path, {gainDb});
+}
+
+std::vector<std::string> SC2470Processor::encodeDuplexState(SC2470Processor::DuplexSetting duplex, std::optional<SC2470::Path> tddPath) const
+{
+    return duplexStateCommands(m_details->slotId, duplex, tddPath);
+}
+
+void SC2470Processor::schedule(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, std::vector<std::string> messages) const
+{
+    scheduler.add(at, m_details->connection, std::move(messages));
+}
+
+PreparedCommand SC2470Processor::prepareGain(SC2470::Path path) const
+{
+    return PreparedCommand(m_details, pathGain, path);
+}
+
+PreparedCommand SC2470Processor::preparePhaseIncrement(SC2470::Path path) const
+{
+    return PreparedCommand(m_details, phaseIncrement, path);
+}
+
+// The asynchronous operations only touch the processor before their first suspension,
+// so they stay valid for as long as the connection does
+
+AsyncResult<SC2470Processor::GainLimitsSet> SC2470Processor::getGainLimitsAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(pathGainLim, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseGainLimits(results[0].value());
+}
+
+AsyncResult<double> SC2470Processor::getGainAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(pathGain, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return ResponseParser::value<double>(results[0].value());
+}
+
+AsyncResult<double> SC2470Processor::setGainAsync(SC2470::Path path, double gainDb, Deadline deadline) const
+{
+    const MessageBuilder::Params params{gainDb};
+    std::vector<std::string> messages{
+        MessageBuilder::buildCommand(pathGain, m_details->slotId, path, params),
+        MessageBuilder::buildQuery(pathGain, m_details->slotId, path),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    co_return ResponseParser::value<double>(results[1].response);
+}
+
+AsyncResult<double> SC2470Processor::getAttnTxAsync(Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(rfPathAttn, m_details->slotId, SC2470::Path::TX)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return ResponseParser::value<double>(results[0].value());
+}
+
+AsyncResult<double> SC2470Processor::setAttnTxAsync(double attnDb, Deadline deadline) const
+{
+    const MessageBuilder::Params params{attnDb};
+    std::vector<std::string> messages{
+        MessageBuilder::buildCommand(rfPathAttn, m_details->slotId, SC2470::Path::TX, params),
+        MessageBuilder::buildQuery(rfPathAttn, m_details->slotId, SC2470::Path::TX),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    co_return ResponseParser::value<double>(results[1].response);
+}
+
+AsyncResult<SC2470Processor::AttenuatorRxSet> SC2470Processor::getAttnRxAsync(Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(ifPathAttn, m_details->slotId, SC2470::Path::RX)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseAttnRx(results[0].value());
+}
+
+AsyncResult<SC2470Processor::AttenuatorRxSet> SC2470Processor::setAttnRxAsync(SC2470Processor::AttenuatorRxSet attns, Deadline deadline) const
+{
+    const MessageBuilder::Params params{attns.attnADb, attns.attnBDb};
+    std::vector<std::string> messages{
+        MessageBuilder::buildCommand(ifPathAttn, m_details->slotId, SC2470::Path::RX, params),
+        MessageBuilder::buildQuery(ifPathAttn, m_details->slotId, SC2470::Path::RX),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    co_return parseAttnRx(results[1].response);
+}
+
+AsyncResult<SC2470Processor::FrequencySet> SC2470Processor::getFrequenciesAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(pathFreq, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseFrequencies(results[0].value());
+}
+
+AsyncResult<SC2470Processor::FrequencySet> SC2470Processor::setFrequenciesAsync(SC2470::Path path, SC2470Processor::FrequencySet freqs, Deadline deadline) const
+{
+    const MessageBuilder::Params params{freqs.rfKHz, freqs.ifKHz, freqs.loKHz};
+    std::vector<std::string> messages{
+        MessageBuilder::buildCommand(pathFreq, m_details->slotId, path, params),
+        MessageBuilder::buildQuery(pathFreq, m_details->slotId, path),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    co_return parseFrequencies(results[1].response);
+}
+
+AsyncResult<double> SC2470Processor::getLoFrequencyKHzAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(loClkFreq, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return ResponseParser::value<double>(results[0].value());
+}
+
+AsyncResult<double> SC2470Processor::setLoFrequencyKHzAsync(SC2470::Path path, double frequencyKhz, Deadline deadline) const
+{
+    const MessageBuilder::Params params{frequencyKhz};
+    std::vector<std::string> messages{
+        MessageBuilder::buildCommand(loClkFreq, m_details->slotId, path, params),
+        MessageBuilder::buildQuery(loClkFreq, m_details->slotId, path),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+
+    for (const TransactionResult& result : results)
+        result.value();
+    co_return ResponseParser::value<double>(results[1].response);
+}
+
+AsyncResult<SC2470Processor::SynthesizerOutputSet> SC2470Processor::getSynthOutputAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{
+        MessageBuilder::buildQuery(synthPower, m_details->slotId, path),
+        MessageBuilder::buildQuery(synthEnable, m_details->slotId, path),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return SynthesizerOutputSet{parseSynthPowerLevel(results[0].value()), parseSynthEnable(results[1].value())};
+}
+
+AsyncResult<bool> SC2470Processor::getLoClkEnableAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(loClkEn, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseEnable(results[0].value());
+}
+
+AsyncResult<SC2470Processor::DuplexState> SC2470Processor::getDuplexStateAsync(Deadline deadline) const
+{
+    std::vector<std::string> messages{
+        MessageBuilder::buildQuery(rfPathPath, m_details->slotId),
+        MessageBuilder::buildQuery(rfPathTdd, m_details->slotId),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return DuplexState{parseRfPath(results[0].value()), parseTddPath(results[1].value())};
+}
+
+AsyncResult<SC2470Processor::SynthesizerReferenceState> SC2470Processor::getSynthReferenceStateAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{
+        MessageBuilder::buildQuery(synthRefAuto, m_details->slotId, path),
+        MessageBuilder::buildQuery(synthRefFreq, m_details->slotId, path),
+    };
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return SynthesizerReferenceState{parseSynthReferenceAuto(results[0].value()), parseSynthReferenceFrequency(results[1].value())};
+}
+
+AsyncResult<SC2470Processor::ReferenceConfig> SC2470Processor::getReferenceConfigAsync(Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(refConfig, m_details->slotId)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseReferenceConfig(results[0].value());
+}
+
+AsyncResult<double> SC2470Processor::getPhaseAccumulatorAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(phaseAccumulator, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return ResponseParser::value<double>(results[0].value());
+}
+
+AsyncResult<SC2470::DCBias> SC2470Processor::getDCBiasAsync(SC2470::Path path, Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(ifPathDCBias, m_details->slotId, path)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseDCBias(results[0].value());
+}
+
+AsyncResult<bool> SC2470Processor::getReferenceOutputEnableAsync(Deadline deadline) const
+{
+    std::vector<std::string> messages{MessageBuilder::buildQuery(refOutputEnable, m_details->slotId)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    co_return parseEnable(results[0].value());
+}
+
+AsyncResult<SC2470Processor::ChannelState> SC2470Processor::getChannelStateAsync(SC2470Processor::ChannelQuery query, Deadline deadline) const
+{
+    std::vector<std::string> messages = channelQueries(m_details->slotId, query);
+    if (messages.empty())
+        co_return ChannelState{};
+
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    ChannelAnswers answers(results);
+    co_return parseChannelState(answers, query);
+}
+
+AsyncResult<std::chrono::steady_clock::time_point> SC2470Processor::writeEncodedAsync(std::string message, Deadline deadline) const
+{
+    std::vector<std::string> messages{std::move(message)};
+    const TransactionResults results = co_await m_details->connection->transactAsync(std::move(messages), deadline);
+    // Resumed on the I/O thread that read the acknowledgement
+    const auto acknowledged = std::chrono::steady_clock::now();
+    results[0].value();
+    co_return acknowledged;
 }
 
 } // namespace fesd
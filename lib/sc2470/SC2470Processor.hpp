@@ -1,11 +1,18 @@
 #pragma once
 
+#include "PreparedCommand.hpp"
 #include "types/DeviceDetails.hpp"
 
+#include <fesd/Async.hpp>
+#include <fesd/CommandScheduler.hpp>
+#include <fesd/Deadline.hpp>
 #include <fesd/types/Common.hpp>
 #include <fesd/types/SC2470.hpp>
 
+#include <chrono>
 #include <cstdint>
+#include <optional>
+#include <string>
 
 namespace fesd
 {
@@ -83,6 +90,93 @@ public:
         uint16_t rfDivider;
     };
 
+    struct SynthesizerOutputSet
+    {
+        SynthesizerPowerSet power;
+        SynthesizerEnableSet enable;
+    };
+
+    struct DuplexState
+    {
+        DuplexSetting rfPath;
+        SC2470::Path tddPath;
+    };
+
+    struct SynthesizerReferenceState
+    {
+        bool automatic;
+        SynthsizerReferenceFreq freq;
+    };
+
+    struct LoFrequencySet
+    {
+        double rxKHz;
+        double txKHz;
+    };
+
+    struct ReferenceSwitch
+    {
+        std::optional<ReferenceConfig> readback; // Only read when asked for
+        std::chrono::nanoseconds timeToLock;     // From sending the change to the lock detect being seen
+    };
+
+    // Settings of a path read by getChannelState, the ones left false are not read
+    struct PathQuery
+    {
+        bool frequencies = false;
+        bool gainLimits = false;
+        bool gain = false;
+        bool attenuation = false; // The TX attenuator or the two RX ones
+        bool synthOutput = false;
+        bool loEnable = false;
+        bool synthReference = false;
+        bool phase = false; // Forced fractional mode and the phase accumulator
+        bool dcBias = false;
+    };
+
+    struct ChannelQuery
+    {
+        bool duplex = false;
+        bool reference = false;
+        bool referenceOutput = false;
+        PathQuery rx;
+        PathQuery tx;
+
+        PathQuery& path(SC2470::Path path) { return (path == SC2470::Path::RX) ? rx : tx; }
+    };
+
+    // Settings of a path, the ones read or the ones to write. Written in the order they are listed in.
+    struct PathState
+    {
+        std::optional<SynthesizerReferenceState> synthReference;
+        std::optional<bool> forceFractional;
+        std::optional<FrequencySet> frequencies;
+        std::optional<double> loKHz; // Written only, retunes the LO and keeps the IF
+        std::optional<double> phaseIncrement; // Written only
+        std::optional<double> phase; // Read only
+        std::optional<GainLimitsSet> gainLimits; // Read only
+        std::optional<double> gainDb;
+        std::optional<double> attnTxDb;
+        std::optional<AttenuatorRxSet> attnRx;
+        std::optional<SynthesizerOutputSet> synthOutput;
+        std::optional<bool> loEnable;
+        std::optional<SC2470::DCBias> dcBias;
+    };
+
+    // Written duplex and reference first, then RX and TX, then the reference output
+    struct ChannelState
+    {
+        std::optional<DuplexState> duplex; // The TDD path is only sent for TDD
+        std::optional<ReferenceConfig> reference;
+        std::optional<bool> referenceOutput;
+        PathState rx;
+        PathState tx;
+        bool apply = false; // Write only, CONFIG:APPLY after the settings when there are any
+
+        PathState& path(SC2470::Path path) { return (path == SC2470::Path::RX) ? rx : tx; }
+        const PathState& path(SC2470::Path path) const { return (path == SC2470::Path::RX) ? rx : tx; }
+    };
+
 public:
     SC2470Processor(std::shared_ptr<DeviceDetails> details) : m_details(details) {};
 public:
@@ -113,13 +207,21 @@ public:
     double getPaBiasCurrent(uint16_t paId) const;
     void setPaBiasCurrent(uint16_t paId, double currentSetpoint) const;
     double getPaBiasVoltage(uint16_t paId) const;
+    // Telemetry, these polls wait for the control commands queued on the port
     double getPaDrainVoltage(uint16_t paId) const;
     double getPaTemp() const;
     double getReferenceDac() const;
     void setReferenceDac(uint32_t dacValue) const;
     SC2470Processor::ReferenceConfig getReferenceConfig() const;
     void setReferenceConfig(const SC2470Processor::ReferenceConfig& config) const;
-    double getReferenceLockDetect() const;
+    double getReferenceLockDetect() const; // Telemetry, for monitoring
+    // Polls the reference lock detect at control priority until it is set and returns the time since the given one, nothing once the time is up.
+    // Polls back off from a fraction of the device's median settle time, each one is recorded in the device's settle statistics.
+    std::optional<std::chrono::nanoseconds> pollReferenceLock(std::chrono::steady_clock::time_point since, std::chrono::steady_clock::time_point until) const;
+    // Same as pollReferenceLock bounded by the retune timeout, a CommunicationError if the reference does not lock
+    std::chrono::nanoseconds waitForReferenceLock(std::chrono::steady_clock::time_point since) const;
+    SettleStats getSettleStats() const;
+    void resetSettleStats() const;
     bool getReferenceOutputEnable() const;
     void setReferenceOutputEnable(bool enable) const;
     bool getForceFractionalMode(SC2470::Path path) const;
@@ -143,6 +245,59 @@ public:
     void setDCBias(SC2470::Path path, SC2470::DCBias bias) const;
     SC2470::DCBias getDCBias(SC2470::Path path) const;
 
+    // Pipelined operations, all commands are sent back to back and set operations return the readback
+    SC2470Processor::SynthesizerOutputSet getSynthOutput(SC2470::Path path) const;
+    SC2470Processor::SynthesizerOutputSet setSynthOutput(SC2470::Path path, const SC2470Processor::SynthesizerOutputSet& settings) const;
+    SC2470Processor::DuplexState getDuplexState(void) const;
+    SC2470Processor::DuplexState setDuplexState(SC2470Processor::DuplexSetting duplex, std::optional<SC2470::Path> tddPath) const;
+    SC2470Processor::SynthesizerReferenceState getSynthReferenceState(SC2470::Path path) const;
+    SC2470Processor::SynthesizerReferenceState setSynthReferenceState(SC2470::Path path, bool automatic, std::optional<SC2470Processor::SynthsizerReferenceFreq> freq) const;
+    SC2470Processor::LoFrequencySet getLoFrequenciesKHz(void) const;
+    // Write-only counterparts of the set operations above, without the readback
+    void writeSynthOutput(SC2470::Path path, const SC2470Processor::SynthesizerOutputSet& settings) const;
+    void writeDuplexState(SC2470Processor::DuplexSetting duplex, std::optional<SC2470::Path> tddPath) const;
+    void writeSynthReferenceState(SC2470::Path path, bool automatic, std::optional<SC2470Processor::SynthsizerReferenceFreq> freq) const;
+    // Reference change and the LO re-applies pipelined with a first lock detect query, then polled until the reference locks
+    SC2470Processor::ReferenceSwitch switchReference(const SC2470Processor::ReferenceConfig& config, SC2470Processor::LoFrequencySet loKHz, bool readback) const;
+    // Settings of a whole channel in one pipelined transaction, the write is followed by the queries of the readback
+    SC2470Processor::ChannelState getChannelState(const SC2470Processor::ChannelQuery& query) const;
+    SC2470Processor::ChannelState writeChannelState(const SC2470Processor::ChannelState& state, const SC2470Processor::ChannelQuery& readback) const;
+    // Frequency command encoded once, for sweeps that send it many times
+    std::string encodeFrequencies(SC2470::Path path, const SC2470Processor::FrequencySet& freqsKHz) const;
+    // Setters encoded once for stepping loops, each send only formats the new value
+    PreparedCommand prepareGain(SC2470::Path path) const;
+    PreparedCommand preparePhaseIncrement(SC2470::Path path) const;
+    // Setters encoded ahead of the time they are scheduled for
+    std::string encodeGain(SC2470::Path path, double gainDb) const;
+    std::vector<std::string> encodeDuplexState(SC2470Processor::DuplexSetting duplex, std::optional<SC2470::Path> tddPath) const;
+    // Sends encoded commands from the scheduler thread once the time comes, without readback
+    void schedule(CommandScheduler& scheduler, std::chrono::steady_clock::time_point at, std::vector<std::string> messages) const;
+
+    // Asynchronous operations, set operations are pipelined with their readback and return it.
+    // The deadline is passed explicitly as these may be started from a coroutine resumed on an I/O thread.
+    AsyncResult<SC2470Processor::GainLimitsSet> getGainLimitsAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<double> getGainAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<double> setGainAsync(SC2470::Path path, double gainDb, Deadline deadline = std::nullopt) const;
+    AsyncResult<double> getAttnTxAsync(Deadline deadline = std::nullopt) const;
+    AsyncResult<double> setAttnTxAsync(double attnDb, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::AttenuatorRxSet> getAttnRxAsync(Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::AttenuatorRxSet> setAttnRxAsync(SC2470Processor::AttenuatorRxSet attns, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::FrequencySet> getFrequenciesAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::FrequencySet> setFrequenciesAsync(SC2470::Path path, SC2470Processor::FrequencySet freqs, Deadline deadline = std::nullopt) const;
+    AsyncResult<double> getLoFrequencyKHzAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<double> setLoFrequencyKHzAsync(SC2470::Path path, double frequencyKhz, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::SynthesizerOutputSet> getSynthOutputAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<bool> getLoClkEnableAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::DuplexState> getDuplexStateAsync(Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::SynthesizerReferenceState> getSynthReferenceStateAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::ReferenceConfig> getReferenceConfigAsync(Deadline deadline = std::nullopt) const;
+    AsyncResult<double> getPhaseAccumulatorAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470::DCBias> getDCBiasAsync(SC2470::Path path, Deadline deadline = std::nullopt) const;
+    AsyncResult<bool> getReferenceOutputEnableAsync(Deadline deadline = std::nullopt) const;
+    AsyncResult<SC2470Processor::ChannelState> getChannelStateAsync(SC2470Processor::ChannelQuery query, Deadline deadline = std::nullopt) const;
+    // Sends a command encoded beforehand without readback, completes with the time the device acknowledged it
+    AsyncResult<std::chrono::steady_clock::time_point> writeEncodedAsync(std::string message, Deadline deadline = std::nullopt) const;
+
 private:
 #pragma warning(push) 
 #pragma warning(disable:4251)
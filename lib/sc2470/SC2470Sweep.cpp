@@ -0,0 +1,248 @@
+#include <fesd/SC2470Sweep.hpp>
+#include <fesd/Deadline.hpp>
+#include <fesd/types/Exception.hpp>
+#include "SC2470Processor.hpp"
+
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Hops queued on the port ahead of the one the device is taking
+constexpr std::size_t SweepWindow = 8;
+
+constexpr char Magic[8] = {'F', 'E', 'S', 'D', 'H', 'O', 'P', 'S'};
+constexpr uint32_t Version = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t hops;
+};
+
+struct HopRecord
+{
+    uint8_t path;
+    uint8_t reserved[3];
+    uint32_t dwellUs;
+    double rfHz;
+    double ifHz;
+    double loHz;
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(HopRecord) == 32, "Hop plan records are packed");
+
+bool parseField(const std::string& text, double& value)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+bool parseHop(const std::string& line, fesd::SC2470::Hop& hop)
+{
+    std::vector<std::string> fields;
+    boost::split(fields, line, boost::is_any_of(","));
+    if (fields.size() != 5)
+        return false;
+    for (std::string& field : fields)
+        boost::trim(field);
+
+    if (boost::iequals(fields[0], "RX"))
+        hop.path = fesd::SC2470::Path::RX;
+    else if (boost::iequals(fields[0], "TX"))
+        hop.path = fesd::SC2470::Path::TX;
+    else
+        return false;
+
+    double dwellUs;
+    if (!parseField(fields[1], hop.frequencies.rfHz) || !parseField(fields[2], hop.frequencies.ifHz) || !parseField(fields[3], hop.frequencies.loHz) || !parseField(fields[4], dwellUs))
+        return false;
+    hop.dwell = std::chrono::microseconds(std::llround(dwellUs));
+    return true;
+}
+
+// Nearest rank of the sorted latencies
+std::chrono::nanoseconds percentile(const std::vector<std::chrono::nanoseconds>& sorted, double fraction)
+{
+    if (sorted.empty())
+        return std::chrono::nanoseconds::zero();
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+namespace fesd {
+
+SC2470Sweep::SC2470Sweep(std::shared_ptr<SC2470Processor> processor, std::vector<SC2470::Hop> hops, std::vector<std::string> messages)
+    : m_processor(std::move(processor)),
+    m_hops(std::move(hops)),
+    m_messages(std::move(messages))
+{
+}
+
+std::vector<SC2470::Hop> SC2470Sweep::readCsv(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw InvalidArgumentsError("Cannot open hop plan: " + path);
+
+    std::vector<SC2470::Hop> hops;
+    std::string line;
+    for (std::size_t lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        boost::trim(line);
+        if (line.empty() || line.starts_with('#'))
+            continue;
+        SC2470::Hop hop{};
+        if (!parseHop(line, hop))
+            throw InvalidArgumentsError("Invalid hop on line " + std::to_string(lineNumber) + " of " + path);
+        hops.push_back(hop);
+    }
+    return hops;
+}
+
+std::vector<SC2470::Hop> SC2470Sweep::readBinary(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw InvalidArgumentsError("Cannot open hop plan: " + path);
+    const std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+
+    FileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        throw InvalidArgumentsError("Not a hop plan: " + path);
+    // Checked before allocating, a corrupt hop count must not size the records
+    if (uint64_t(header.hops) * sizeof(HopRecord) > uint64_t(fileSize - file.tellg()))
+        throw InvalidArgumentsError("Truncated hop plan: " + path);
+
+    std::vector<HopRecord> records(header.hops);
+    if (!file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(HopRecord)))
+        throw InvalidArgumentsError("Truncated hop plan: " + path);
+
+    std::vector<SC2470::Hop> hops;
+    hops.reserve(records.size());
+    for (const HopRecord& record : records)
+    {
+        if (record.path > 1)
+            throw InvalidArgumentsError("Invalid hop " + std::to_string(hops.size()) + " in " + path);
+        const SC2470::Path hopPath = (record.path == 0) ? SC2470::Path::RX : SC2470::Path::TX;
+        hops.push_back({hopPath, {record.rfHz, record.ifHz, record.loHz}, std::chrono::microseconds(record.dwellUs)});
+    }
+    return hops;
+}
+
+void SC2470Sweep::writeBinary(const std::string& path, std::span<const SC2470::Hop> hops)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw InvalidArgumentsError("Cannot create hop plan: " + path);
+
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.hops = static_cast<uint32_t>(hops.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const SC2470::Hop& hop : hops)
+    {
+        HopRecord record{};
+        record.path = (hop.path == SC2470::Path::RX) ? 0 : 1;
+        record.dwellUs = static_cast<uint32_t>(std::max<int64_t>(hop.dwell.count(), 0));
+        record.rfHz = hop.frequencies.rfHz;
+        record.ifHz = hop.frequencies.ifHz;
+        record.loHz = hop.frequencies.loHz;
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    if (!file)
+        throw InvalidArgumentsError("Cannot write hop plan: " + path);
+}
+
+void SC2470Sweep::setHopCallback(HopCallback callback)
+{
+    m_callback = std::move(callback);
+}
+
+std::size_t SC2470Sweep::size(void) const
+{
+    return m_hops.size();
+}
+
+SC2470::SweepReport SC2470Sweep::run(void) const
+{
+    struct InFlight
+    {
+        std::size_t index;
+        Clock::time_point sent;
+        AsyncResult<Clock::time_point> acknowledged;
+    };
+
+    std::deque<InFlight> inFlight;
+    std::vector<std::chrono::nanoseconds> latencies;
+    latencies.reserve(m_hops.size());
+    const Clock::time_point start = Clock::now();
+    Clock::time_point previous = start;
+
+    // A queued hop only reaches the device once the one before it is acknowledged
+    auto complete = [&]() {
+        InFlight hop = std::move(inFlight.front());
+        inFlight.pop_front();
+        const Clock::time_point acknowledged = hop.acknowledged.get();
+        latencies.push_back(acknowledged - std::max(hop.sent, previous));
+        previous = acknowledged;
+        if (m_callback)
+            m_callback(hop.index, m_hops[hop.index]);
+    };
+
+    try
+    {
+        for (std::size_t i = 0; i < m_hops.size(); i++)
+        {
+            // A hop that dwells or is reported is settled before the next one goes out
+            if (i > 0 && (m_callback || m_hops[i - 1].dwell.count() > 0))
+            {
+                while (!inFlight.empty())
+                    complete();
+                std::this_thread::sleep_until(previous + m_hops[i - 1].dwell);
+            }
+            while (inFlight.size() >= SweepWindow)
+                complete();
+            inFlight.push_back({i, Clock::now(), m_processor->writeEncodedAsync(m_messages[i], DeadlineScope::current())});
+        }
+        while (!inFlight.empty())
+            complete();
+    }
+    catch (...)
+    {
+        for (const InFlight& hop : inFlight)
+            hop.acknowledged.wait();
+        throw;
+    }
+    if (!m_hops.empty())
+        std::this_thread::sleep_until(previous + m_hops.back().dwell);
+
+    const std::chrono::nanoseconds elapsed = Clock::now() - start;
+    std::sort(latencies.begin(), latencies.end());
+
+    SC2470::SweepReport report{};
+    report.hops = m_hops.size();
+    report.elapsed = elapsed;
+    report.hopsPerSecond = (elapsed.count() > 0) ? m_hops.size() / std::chrono::duration<double>(elapsed).count() : 0.0;
+    report.latencyP50 = percentile(latencies, 0.50);
+    report.latencyP90 = percentile(latencies, 0.90);
+    report.latencyP99 = percentile(latencies, 0.99);
+    report.latencyMax = latencies.empty() ? std::chrono::nanoseconds::zero() : latencies.back();
+    return report;
+}
+
+} // namespace fesd
@@ -0,0 +1,720 @@
+#include "SC2470Simulator.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+const std::string Manufacturer = "SignalCraft Technologies";
+const std::string Model = "SC2470";
+
+std::vector<std::string_view> splitTokens(std::string_view line)
+{
+    std::vector<std::string_view> tokens;
+    while (!line.empty())
+    {
+        const std::size_t start = line.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+            break;
+        line.remove_prefix(start);
+        const std::size_t end = std::min(line.find(' '), line.size());
+        tokens.push_back(line.substr(0, end));
+        line.remove_prefix(end);
+    }
+    return tokens;
+}
+
+std::string formatValue(double value)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%f", value);
+    return buffer;
+}
+
+bool parseValue(std::string_view text, double& value)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+template <typename T>
+bool parseInteger(std::string_view text, T& value, int base = 10)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+bool parseOnOff(std::string_view text, bool& value)
+{
+    if (text == "ON")
+        value = true;
+    else if (text == "OFF")
+        value = false;
+    else
+        return false;
+    return true;
+}
+
+bool parseFlag(std::string_view text, bool& value)
+{
+    if (text == "1")
+        value = true;
+    else if (text == "0")
+        value = false;
+    else
+        return false;
+    return true;
+}
+
+const char* onOff(bool value)
+{
+    return value ? "ON" : "OFF";
+}
+
+const char* flag(bool value)
+{
+    return value ? "1" : "0";
+}
+
+} // namespace
+
+namespace fesd {
+namespace sim {
+
+SC2470Simulator::SC2470Simulator(Settings settings) : m_settings(std::move(settings))
+{
+    m_slots.resize(std::max<uint16_t>(m_settings.slots, 1));
+    for (std::size_t slotId = 1; slotId < m_slots.size(); slotId++)
+        m_slots[slotId].state.role = "SLAVE";
+    for (Slot& slot : m_slots)
+        slot.nvm = slot.state;
+
+    m_handlers = {
+        {"*IDN",             &SC2470Simulator::identification},
+        {"MAINT:GETMANUF",   &SC2470Simulator::manufacturing},
+        {"SYS:ROLE",         &SC2470Simulator::systemRole},
+        {"SYS:NCHAN",        &SC2470Simulator::numberOfChannels},
+        {"PATH:FREQ",        &SC2470Simulator::pathFrequency},
+        {"PATH:GAIN",        &SC2470Simulator::pathGain},
+        {"PATH:GAINLIM",     &SC2470Simulator::pathGainLimits},
+        {"RFPATH:ATTN",      &SC2470Simulator::rfPathAttenuation},
+        {"IFPATH:ATTN",      &SC2470Simulator::ifPathAttenuation},
+        {"IFPATH:DCBIAS",    &SC2470Simulator::ifPathDCBias},
+        {"RFPATH:PATH",      &SC2470Simulator::rfPathDuplex},
+        {"RFPATH:TDD",       &SC2470Simulator::rfPathTdd},
+        {"LOCLK:FREQ",       &SC2470Simulator::loFrequency},
+        {"LOCLK:EN",         &SC2470Simulator::loEnable},
+        {"LOCLK:PHINC",      &SC2470Simulator::phaseIncrement},
+        {"LOCLK:PHCUMU",     &SC2470Simulator::phaseAccumulator},
+        {"SYN:POW",          &SC2470Simulator::synthPower},
+        {"SYN:EN",           &SC2470Simulator::synthEnable},
+        {"SYN:REFFREQ",      &SC2470Simulator::synthReferenceFrequency},
+        {"SYN:AUTOREF",      &SC2470Simulator::synthReferenceAuto},
+        {"SYN:FFRAC",        &SC2470Simulator::synthFractionalMode},
+        {"SYN:RFSET",        &SC2470Simulator::synthRfSet},
+        {"REFPLL:CONFIG",    &SC2470Simulator::referenceConfig},
+        {"REFPLL:LD",        &SC2470Simulator::referenceLockDetect},
+        {"REFPLL:OUTPUT",    &SC2470Simulator::referenceOutput},
+        {"REFDAC:DAC",       &SC2470Simulator::referenceDac},
+        {"BIAS:PAVOLT",      &SC2470Simulator::paDrainVoltage},
+        {"BIAS:TEMP",        &SC2470Simulator::paTemperature},
+        {"CONFIG:APPLY",     &SC2470Simulator::configApply},
+        {"CONFIG:DEFAULT",   &SC2470Simulator::configDefault},
+        {"CONFIG:LOAD",      &SC2470Simulator::configLoad},
+        {"CONFIG:SAVE",      &SC2470Simulator::configSave},
+        {"CONFIG:AUTOLOAD",  &SC2470Simulator::configAutoLoad},
+        {"CONFIG:AUTOPHASE", &SC2470Simulator::configAutoPhase},
+    };
+}
+
+const SC2470Simulator::Settings& SC2470Simulator::settings(void) const
+{
+    return m_settings;
+}
+
+SC2470Simulator::Reply SC2470Simulator::process(std::string_view line)
+{
+    const std::vector<std::string_view> tokens = splitTokens(line);
+
+    // An empty line only gets a fresh prompt
+    if (tokens.empty())
+        return {">", 0us, 0ms};
+
+    std::string mnemonic(tokens[0]);
+    const bool query = mnemonic.back() == '?';
+    if (query)
+        mnemonic.pop_back();
+
+    Reply reply{"", commandTime(mnemonic), 0ms};
+
+    // Port level command, no slot id
+    if (mnemonic == "VER")
+    {
+        reply.bytes = frame(0, !query, query ? "" : formatValue(m_settings.firmwareVersion));
+        return reply;
+    }
+
+    uint16_t slotId = 0;
+    if (tokens.size() < 2 || !parseInteger(tokens[1], slotId) || slotId >= m_slots.size())
+    {
+        reply.bytes = frame(0, false, "");
+        return reply;
+    }
+
+    // Reboot, the device reloads its configuration and stays silent until it is back up
+    if (mnemonic == "*RST" && !query)
+    {
+        for (Slot& slot : m_slots)
+        {
+            if (slot.state.autoLoad)
+                slot.state = slot.nvm;
+            relock(slot);
+        }
+        reply.rebootTime = m_settings.rebootTime;
+        return reply;
+    }
+
+    const auto handler = m_handlers.find(mnemonic);
+    if (handler == m_handlers.end())
+    {
+        reply.bytes = frame(slotId, false, "");
+        return reply;
+    }
+
+    Request request{query, {tokens.begin() + 2, tokens.end()}};
+    std::string payload;
+    const bool success = (this->*(handler->second))(m_slots[slotId], slotId, request, payload);
+    reply.bytes = frame(slotId, success, success ? payload : "");
+    return reply;
+}
+
+std::string SC2470Simulator::frame(uint16_t slotId, bool success, const std::string& payload) const
+{
+    const std::string prefix = (slotId > 0) ? "[ " + std::to_string(slotId) + " ] " : "";
+    std::string bytes;
+
+    if (!payload.empty())
+        bytes += prefix + payload;
+    bytes += "\r" + prefix + (success ? "OK" : "ERR") + "\r>";
+    return bytes;
+}
+
+std::chrono::microseconds SC2470Simulator::commandTime(const std::string& mnemonic) const
+{
+    const auto override = m_settings.commandTimes.find(mnemonic);
+    if (override != m_settings.commandTimes.end())
+        return override->second;
+    return m_settings.processingTime;
+}
+
+void SC2470Simulator::relock(Slot& slot)
+{
+    slot.lockedAt = std::chrono::steady_clock::now() + m_settings.lockTime;
+}
+
+namespace {
+
+// Selects the path named by the first argument
+template <typename Slot, typename PathState>
+PathState* selectPath(Slot& slot, const std::vector<std::string_view>& args)
+{
+    if (args.empty())
+        return nullptr;
+    if (args[0] == "RX")
+        return &slot.state.rx;
+    if (args[0] == "TX")
+        return &slot.state.tx;
+    return nullptr;
+}
+
+// Gain range narrows as the RF frequency increases
+void gainLimits(double rfKHz, double& minDb, double& maxDb)
+{
+    maxDb = 30.0 - (0.5 * ((rfKHz / 1.0E6) - 6.7));
+    minDb = maxDb - 31.5;
+}
+
+} // namespace
+
+#define SELECT_PATH(slot, request)                                     \
+    PathState* path = selectPath<Slot, PathState>(slot, request.args); \
+    if (path == nullptr)                                               \
+        return false;
+
+bool SC2470Simulator::identification(Slot&, uint16_t slotId, const Request& request, std::string& payload)
+{
+    if (!request.query)
+        return false;
+
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%s,%s,%08X,%.2f", Manufacturer.c_str(), Model.c_str(), m_settings.serialNumber + slotId, m_settings.firmwareVersion);
+    payload = buffer;
+    return true;
+}
+
+bool SC2470Simulator::manufacturing(Slot&, uint16_t slotId, const Request& request, std::string& payload)
+{
+    if (!request.query)
+        return false;
+
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "#H%08X 20240101 %.2f", m_settings.serialNumber + slotId, m_settings.hardwareVersion);
+    payload = buffer;
+    return true;
+}
+
+bool SC2470Simulator::systemRole(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = slot.state.role;
+        return true;
+    }
+    if (request.args.size() != 1 || (request.args[0] != "MASTER" && request.args[0] != "SLAVE"))
+        return false;
+    slot.state.role = std::string(request.args[0]);
+    return true;
+}
+
+bool SC2470Simulator::numberOfChannels(Slot&, uint16_t, const Request& request, std::string& payload)
+{
+    if (!request.query)
+        return false;
+    payload = std::to_string(m_slots.size());
+    return true;
+}
+
+bool SC2470Simulator::pathFrequency(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = formatValue(path->rfKHz) + " " + formatValue(path->ifKHz) + " " + formatValue(path->loKHz);
+        return true;
+    }
+
+    double rfKHz, ifKHz, loKHz;
+    if (request.args.size() != 4 || !parseValue(request.args[1], rfKHz) || !parseValue(request.args[2], ifKHz) || !parseValue(request.args[3], loKHz))
+        return false;
+
+    // The frequency given as 0 is derived from the other two, bypass has RF == IF and no LO
+    const bool bypass = (loKHz == 0.0) && (rfKHz == ifKHz);
+    if (!bypass)
+    {
+        if (loKHz == 0.0)
+            loKHz = rfKHz - ifKHz;
+        else if (rfKHz == 0.0)
+            rfKHz = loKHz + ifKHz;
+        else if (ifKHz == 0.0)
+            ifKHz = rfKHz - loKHz;
+    }
+    if (rfKHz <= 0.0 || ifKHz <= 0.0 || loKHz < 0.0)
+        return false;
+
+    path->rfKHz = rfKHz;
+    path->ifKHz = ifKHz;
+    path->loKHz = loKHz;
+    path->phase = 0.0;
+
+    double minDb, maxDb;
+    gainLimits(path->rfKHz, minDb, maxDb);
+    path->gainDb = std::clamp(path->gainDb, minDb, maxDb);
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::pathGain(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = formatValue(path->gainDb);
+        return true;
+    }
+
+    double gainDb, minDb, maxDb;
+    if (request.args.size() != 2 || !parseValue(request.args[1], gainDb))
+        return false;
+    gainLimits(path->rfKHz, minDb, maxDb);
+    path->gainDb = std::clamp(gainDb, minDb, maxDb);
+    return true;
+}
+
+bool SC2470Simulator::pathGainLimits(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (!request.query)
+        return false;
+
+    double minDb, maxDb;
+    gainLimits(path->rfKHz, minDb, maxDb);
+    payload = formatValue(minDb) + " " + formatValue(maxDb);
+    return true;
+}
+
+bool SC2470Simulator::rfPathAttenuation(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.args.empty() || request.args[0] != "TX")
+        return false;
+
+    if (request.query)
+    {
+        payload = formatValue(slot.state.attnTxDb);
+        return true;
+    }
+
+    double attnDb;
+    if (request.args.size() != 2 || !parseValue(request.args[1], attnDb))
+        return false;
+    slot.state.attnTxDb = std::clamp(attnDb, 0.0, 31.5);
+    return true;
+}
+
+bool SC2470Simulator::ifPathAttenuation(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.args.empty() || request.args[0] != "RX")
+        return false;
+
+    if (request.query)
+    {
+        payload = formatValue(slot.state.attnADb) + " " + formatValue(slot.state.attnBDb);
+        return true;
+    }
+
+    double attnADb, attnBDb;
+    if (request.args.size() != 3 || !parseValue(request.args[1], attnADb) || !parseValue(request.args[2], attnBDb))
+        return false;
+    slot.state.attnADb = std::clamp(attnADb, 0.0, 31.75);
+    slot.state.attnBDb = std::clamp(attnBDb, 0.0, 31.5);
+    return true;
+}
+
+bool SC2470Simulator::ifPathDCBias(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = std::to_string(path->dcBiasI) + " " + std::to_string(path->dcBiasQ);
+        return true;
+    }
+
+    int biasI, biasQ;
+    if (request.args.size() != 3 || !parseInteger(request.args[1], biasI) || !parseInteger(request.args[2], biasQ))
+        return false;
+    path->dcBiasI = std::clamp(biasI, -2048, 2047);
+    path->dcBiasQ = std::clamp(biasQ, -2048, 2047);
+    return true;
+}
+
+bool SC2470Simulator::rfPathDuplex(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = slot.state.rfPath;
+        return true;
+    }
+    if (request.args.size() != 1 || (request.args[0] != "FDD" && request.args[0] != "TDD"))
+        return false;
+    slot.state.rfPath = std::string(request.args[0]);
+    return true;
+}
+
+bool SC2470Simulator::rfPathTdd(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = slot.state.tddPath;
+        return true;
+    }
+    if (request.args.size() != 1 || (request.args[0] != "RX" && request.args[0] != "TX"))
+        return false;
+    slot.state.tddPath = std::string(request.args[0]);
+    return true;
+}
+
+bool SC2470Simulator::loFrequency(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = formatValue(path->loKHz);
+        return true;
+    }
+
+    double loKHz;
+    if (request.args.size() != 2 || !parseValue(request.args[1], loKHz) || loKHz <= 0.0)
+        return false;
+    path->loKHz = loKHz;
+    path->rfKHz = path->loKHz + path->ifKHz;
+    // Retuning the LO resets the phase accumulator
+    path->phase = 0.0;
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::loEnable(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = onOff(path->loEnable);
+        return true;
+    }
+    return request.args.size() == 2 && parseOnOff(request.args[1], path->loEnable);
+}
+
+bool SC2470Simulator::phaseIncrement(Slot& slot, uint16_t, const Request& request, std::string&)
+{
+    SELECT_PATH(slot, request)
+
+    double increment;
+    if (request.query || request.args.size() != 2 || !parseValue(request.args[1], increment))
+        return false;
+    path->phase = std::fmod(path->phase + increment, 360.0);
+    return true;
+}
+
+bool SC2470Simulator::phaseAccumulator(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = formatValue(path->phase);
+        return true;
+    }
+
+    double phase;
+    if (request.args.size() != 2 || !parseValue(request.args[1], phase))
+        return false;
+    path->phase = std::fmod(phase, 360.0);
+    return true;
+}
+
+bool SC2470Simulator::synthPower(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = std::to_string(path->power1x) + " " + std::to_string(path->power2x);
+        return true;
+    }
+
+    uint16_t power1x, power2x;
+    if (request.args.size() != 3 || !parseInteger(request.args[1], power1x) || !parseInteger(request.args[2], power2x))
+        return false;
+    path->power1x = std::min<uint16_t>(power1x, 15);
+    path->power2x = std::min<uint16_t>(power2x, 15);
+    return true;
+}
+
+bool SC2470Simulator::synthEnable(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = std::string(onOff(path->enable1x)) + " " + onOff(path->enable2x);
+        return true;
+    }
+    return request.args.size() == 3 && parseOnOff(request.args[1], path->enable1x) && parseOnOff(request.args[2], path->enable2x);
+}
+
+bool SC2470Simulator::synthReferenceFrequency(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = formatValue(path->synthRefKHz);
+        return true;
+    }
+
+    double refKHz;
+    if (request.args.size() != 2 || !parseValue(request.args[1], refKHz) || (refKHz != 100000.0 && refKHz != 105000.0))
+        return false;
+    path->synthRefKHz = refKHz;
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::synthReferenceAuto(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = flag(path->synthRefAuto);
+        return true;
+    }
+    return request.args.size() == 2 && parseFlag(request.args[1], path->synthRefAuto);
+}
+
+bool SC2470Simulator::synthFractionalMode(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (request.query)
+    {
+        payload = flag(path->forceFractional);
+        return true;
+    }
+    return request.args.size() == 2 && parseFlag(request.args[1], path->forceFractional);
+}
+
+bool SC2470Simulator::synthRfSet(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    SELECT_PATH(slot, request)
+
+    if (!request.query)
+        return false;
+
+    // Integer-N when the LO is a multiple of the synthesizer reference
+    const double refKHz = path->synthRefAuto ? 100000.0 : path->synthRefKHz;
+    const double ratio = path->loKHz / refKHz;
+    const double intDivider = std::floor(ratio);
+    const uint32_t frac1 = static_cast<uint32_t>(std::round((ratio - intDivider) * (1 << 24))) & 0xFFFFFF;
+
+    payload = std::to_string(static_cast<uint16_t>(intDivider)) + " " + std::to_string(frac1) + " 0 1 1";
+    return true;
+}
+
+bool SC2470Simulator::referenceConfig(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = slot.state.refSource + " " + formatValue(slot.state.refKHz);
+        return true;
+    }
+
+    double refKHz;
+    if (request.args.size() != 2 || !parseValue(request.args[1], refKHz))
+        return false;
+    if (request.args[0] == "INT" && refKHz != 100000.0)
+        return false;
+    if (request.args[0] != "INT" && (request.args[0] != "EXT" || (refKHz != 10000.0 && refKHz != 100000.0)))
+        return false;
+
+    slot.state.refSource = std::string(request.args[0]);
+    slot.state.refKHz = refKHz;
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::referenceLockDetect(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (!request.query)
+        return false;
+    payload = flag(std::chrono::steady_clock::now() >= slot.lockedAt);
+    return true;
+}
+
+bool SC2470Simulator::referenceOutput(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = onOff(slot.state.refOutput);
+        return true;
+    }
+    return request.args.size() == 1 && parseOnOff(request.args[0], slot.state.refOutput);
+}
+
+bool SC2470Simulator::referenceDac(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = std::to_string(slot.state.refDac);
+        return true;
+    }
+    if (request.args.size() != 1 || !request.args[0].starts_with("0x"))
+        return false;
+    return parseInteger(request.args[0].substr(2), slot.state.refDac, 16);
+}
+
+bool SC2470Simulator::paDrainVoltage(Slot&, uint16_t, const Request& request, std::string& payload)
+{
+    if (!request.query || request.args.size() != 1)
+        return false;
+    payload = formatValue(28.0);
+    return true;
+}
+
+bool SC2470Simulator::paTemperature(Slot&, uint16_t, const Request& request, std::string& payload)
+{
+    if (!request.query)
+        return false;
+    payload = formatValue(41.5);
+    return true;
+}
+
+bool SC2470Simulator::configApply(Slot& slot, uint16_t, const Request& request, std::string&)
+{
+    if (request.query)
+        return false;
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::configDefault(Slot& slot, uint16_t, const Request& request, std::string&)
+{
+    if (request.query)
+        return false;
+    const std::string role = slot.state.role;
+    slot.state = SlotState();
+    slot.state.role = role;
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::configLoad(Slot& slot, uint16_t, const Request& request, std::string&)
+{
+    if (request.query)
+        return false;
+    slot.state = slot.nvm;
+    relock(slot);
+    return true;
+}
+
+bool SC2470Simulator::configSave(Slot& slot, uint16_t, const Request& request, std::string&)
+{
+    if (request.query)
+        return false;
+    slot.nvm = slot.state;
+    return true;
+}
+
+bool SC2470Simulator::configAutoLoad(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = flag(slot.state.autoLoad);
+        return true;
+    }
+    return request.args.size() == 1 && parseFlag(request.args[0], slot.state.autoLoad);
+}
+
+bool SC2470Simulator::configAutoPhase(Slot& slot, uint16_t, const Request& request, std::string& payload)
+{
+    if (request.query)
+    {
+        payload = flag(slot.state.autoPhase);
+        return true;
+    }
+    return request.args.size() == 1 && parseFlag(request.args[0], slot.state.autoPhase);
+}
+
+#undef SELECT_PATH
+
+} // namespace sim
+} // namespace fesd
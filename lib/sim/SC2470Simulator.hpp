@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fesd {
+namespace sim {
+
+// Behavioural model of a chain of SC2470 devices behind one serial port.
+// Speaks the console protocol: CR terminated commands, "OK"/"ERR" status lines and a ">" prompt.
+class SC2470Simulator final
+{
+public:
+    struct Settings
+    {
+        uint16_t slots = 1; // Slot 0 is the controller, others answer with a "[ n ] " prefix
+        uint32_t serialNumber = 0x00C0FFEE; // Serial number of slot 0, following slots count up
+        double firmwareVersion = 1.2;
+        double hardwareVersion = 2.1;
+        std::chrono::microseconds processingTime{200};          // Default per-command processing time
+        std::map<std::string, std::chrono::microseconds> commandTimes; // Per-mnemonic overrides, e.g. "CONFIG:SAVE"
+        std::chrono::microseconds lockTime{500};                // Time the PLLs take to relock after a retune
+        std::chrono::milliseconds rebootTime{3000};             // Silence after *RST
+    };
+
+    struct Reply
+    {
+        std::string bytes; // Everything the device sends back including the prompt, empty when it stays silent
+        std::chrono::microseconds processingTime;
+        std::chrono::milliseconds rebootTime; // Non-zero when the command rebooted the device
+    };
+
+public:
+    SC2470Simulator(Settings settings);
+
+    // Processes a single command line without its CR terminator
+    Reply process(std::string_view line);
+    const Settings& settings(void) const;
+
+private:
+    struct PathState
+    {
+        double rfKHz = 12000000.0;
+        double ifKHz = 2000000.0;
+        double loKHz = 10000000.0;
+        double gainDb = 0.0;
+        uint16_t power1x = 10;
+        uint16_t power2x = 10;
+        bool enable1x = true;
+        bool enable2x = false;
+        bool synthRefAuto = true;
+        double synthRefKHz = 100000.0;
+        bool forceFractional = false;
+        double phase = 0.0;
+        bool loEnable = true;
+        int dcBiasI = 0;
+        int dcBiasQ = 0;
+    };
+
+    struct SlotState
+    {
+        PathState rx;
+        PathState tx;
+        double attnTxDb = 0.0;
+        double attnADb = 0.0;
+        double attnBDb = 0.0;
+        std::string rfPath = "FDD";
+        std::string tddPath = "RX";
+        std::string refSource = "INT";
+        double refKHz = 100000.0;
+        bool refOutput = false;
+        uint32_t refDac = 0x8000;
+        bool autoLoad = true;
+        bool autoPhase = false;
+        std::string role = "MASTER";
+    };
+
+    struct Slot
+    {
+        SlotState state;
+        SlotState nvm;
+        std::chrono::steady_clock::time_point lockedAt;
+    };
+
+    struct Request
+    {
+        bool query;
+        std::vector<std::string_view> args; // Arguments after the slot id
+    };
+
+    using Handler = bool (SC2470Simulator::*)(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+
+private:
+    bool identification(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool manufacturing(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool systemRole(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool numberOfChannels(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool pathFrequency(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool pathGain(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool pathGainLimits(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool rfPathAttenuation(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool ifPathAttenuation(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool ifPathDCBias(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool rfPathDuplex(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool rfPathTdd(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool loFrequency(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool loEnable(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool phaseIncrement(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool phaseAccumulator(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool synthPower(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool synthEnable(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool synthReferenceFrequency(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool synthReferenceAuto(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool synthFractionalMode(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool synthRfSet(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool referenceConfig(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool referenceLockDetect(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool referenceOutput(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool referenceDac(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool paDrainVoltage(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool paTemperature(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool configApply(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool configDefault(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool configLoad(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool configSave(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool configAutoLoad(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+    bool configAutoPhase(Slot& slot, uint16_t slotId, const Request& request, std::string& payload);
+
+    std::string frame(uint16_t slotId, bool success, const std::string& payload) const;
+    std::chrono::microseconds commandTime(const std::string& mnemonic) const;
+    void relock(Slot& slot);
+
+private:
+    Settings m_settings;
+    std::vector<Slot> m_slots;
+    std::map<std::string, Handler> m_handlers;
+};
+
+} // namespace sim
+} // namespace fesd
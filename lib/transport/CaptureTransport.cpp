@@ -0,0 +1,55 @@
+#include "CaptureTransport.hpp"
+
+namespace fesd {
+
+CaptureTransport::CaptureTransport(std::shared_ptr<Transport> inner, const std::string& path)
+    : m_inner(std::move(inner)), m_log(std::make_shared<WireLog::Writer>(path))
+{
+}
+
+void CaptureTransport::asyncOpen(Handler handler)
+{
+    m_inner->asyncOpen(
+        [log = m_log, handler = std::move(handler)](const boost::system::error_code& error, std::size_t size)
+        {
+            if (!error)
+                log->append(WireLog::Direction::Open, std::string_view());
+            handler(error, size);
+        }
+    );
+}
+
+void CaptureTransport::close(void)
+{
+    m_inner->close();
+}
+
+void CaptureTransport::asyncWrite(std::span<const std::string_view> buffers, Handler handler)
+{
+    m_log->append(WireLog::Direction::Tx, buffers);
+    m_inner->asyncWrite(buffers, std::move(handler));
+}
+
+void CaptureTransport::asyncRead(std::span<char> buffer, Handler handler)
+{
+    m_inner->asyncRead(buffer,
+        [log = m_log, buffer, handler = std::move(handler)](const boost::system::error_code& error, std::size_t size)
+        {
+            if (size > 0)
+                log->append(WireLog::Direction::Rx, std::string_view(buffer.data(), size));
+            handler(error, size);
+        }
+    );
+}
+
+void CaptureTransport::cancel(void)
+{
+    m_inner->cancel();
+}
+
+const std::string& CaptureTransport::name(void) const
+{
+    return m_inner->name();
+}
+
+} // namespace fesd
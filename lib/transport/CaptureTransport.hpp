@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Transport.hpp"
+#include "WireLog.hpp"
+
+namespace fesd {
+
+// Records everything another backend sends and receives to a wire log, "?capture=path" on any port.
+// Writes are recorded when they are started and reads when they complete, on the I/O thread.
+class CaptureTransport final : public Transport
+{
+public:
+    CaptureTransport(std::shared_ptr<Transport> inner, const std::string& path);
+
+    void asyncOpen(Handler handler) override;
+    void close(void) override;
+    void asyncWrite(std::span<const std::string_view> buffers, Handler handler) override;
+    void asyncRead(std::span<char> buffer, Handler handler) override;
+    void cancel(void) override;
+    const std::string& name(void) const override;
+
+private:
+    std::shared_ptr<Transport> m_inner;
+    std::shared_ptr<WireLog::Writer> m_log;
+};
+
+} // namespace fesd
@@ -0,0 +1,147 @@
+#include "LoopbackTransport.hpp"
+#include "PortSpec.hpp"
+#include "sim/SC2470Simulator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const char Etx = 0x03;
+const char Termination = '\r';
+
+// FNV-1a, stable across platforms so virtual serial numbers do not change between runs
+uint32_t hashName(const std::string& name)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : name)
+    {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+namespace fesd {
+
+[[nodiscard]] std::shared_ptr<LoopbackTransport> LoopbackTransport::makeSimulated(const PortSpec& spec, boost::asio::io_context& io)
+{
+    sim::SC2470Simulator::Settings settings;
+    settings.slots = static_cast<uint16_t>(std::max<unsigned long>(spec.numericOption("slots", 1), 1));
+    settings.serialNumber = static_cast<uint32_t>(spec.numericOption("serial", hashName(spec.address), 16));
+
+    auto simulator = std::make_shared<sim::SC2470Simulator>(settings);
+    return std::make_shared<LoopbackTransport>("sim://" + spec.address, 
+        [simulator](std::string_view line)
+        {
+            return simulator->process(line).bytes;
+        },
+        io
+    );
+}
+
+LoopbackTransport::LoopbackTransport(std::string name, Responder responder, boost::asio::io_context& io)
+    : m_name(std::move(name)), m_responder(std::move(responder)), m_io(io)
+{
+}
+
+void LoopbackTransport::asyncOpen(Handler handler)
+{
+    m_open = true;
+    m_line.clear();
+    m_output.clear();
+    m_outputBegin = 0;
+    complete(std::move(handler), {}, 0);
+}
+
+void LoopbackTransport::close(void)
+{
+    cancel();
+    m_open = false;
+}
+
+void LoopbackTransport::asyncWrite(std::span<const std::string_view> buffers, Handler handler)
+{
+    if (!m_open)
+    {
+        complete(std::move(handler), boost::asio::error::bad_descriptor, 0);
+        return;
+    }
+
+    std::size_t size = 0;
+    for (std::string_view buffer : buffers)
+    {
+        size += buffer.size();
+        while (!buffer.empty())
+        {
+            const std::size_t control = buffer.find_first_of(std::string_view("\r\x03", 2));
+            m_line.append(buffer.substr(0, control));
+            if (control == std::string_view::npos)
+                break;
+
+            // ETX clears the device input buffer, CR completes a command
+            if (buffer[control] == Termination)
+                m_output += m_responder(m_line);
+            m_line.clear();
+            buffer.remove_prefix(control + 1);
+        }
+    }
+    complete(std::move(handler), {}, size);
+
+    if (m_readHandler && m_outputBegin < m_output.size())
+        complete(std::exchange(m_readHandler, nullptr), {}, take(m_readBuffer));
+}
+
+void LoopbackTransport::asyncRead(std::span<char> buffer, Handler handler)
+{
+    if (!m_open)
+        complete(std::move(handler), boost::asio::error::bad_descriptor, 0);
+    else if (m_outputBegin < m_output.size())
+        complete(std::move(handler), {}, take(buffer));
+    else
+    {
+        // Responses are produced as commands are written
+        m_readBuffer = buffer;
+        m_readHandler = std::move(handler);
+    }
+}
+
+void LoopbackTransport::cancel(void)
+{
+    if (m_readHandler)
+        complete(std::exchange(m_readHandler, nullptr), boost::asio::error::operation_aborted, 0);
+}
+
+const std::string& LoopbackTransport::name(void) const
+{
+    return m_name;
+}
+
+// Handlers are never called from inside the initiating function, same as asio
+void LoopbackTransport::complete(Handler handler, const boost::system::error_code& error, std::size_t size)
+{
+    boost::asio::post(m_io, 
+        [handler = std::move(handler), error, size]()
+        {
+            handler(error, size);
+        }
+    );
+}
+
+std::size_t LoopbackTransport::take(std::span<char> buffer)
+{
+    const std::size_t count = std::min(buffer.size(), m_output.size() - m_outputBegin);
+    std::memcpy(buffer.data(), m_output.data() + m_outputBegin, count);
+    m_outputBegin += count;
+    if (m_outputBegin == m_output.size())
+    {
+        m_output.clear();
+        m_outputBegin = 0;
+    }
+    return count;
+}
+
+} // namespace fesd
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Transport.hpp"
+
+namespace fesd {
+
+struct PortSpec;
+
+// In-process backend, every command line is answered synchronously by a device model without any system calls.
+// Lets the host side stack be measured on its own and large numbers of virtual devices run in one process.
+class LoopbackTransport final : public Transport
+{
+public:
+    // Returns everything the device sends back for one command line (without its CR), including the prompt
+    using Responder = std::function<std::string(std::string_view line)>;
+
+    // "sim://name?slots=N&serial=HEX" answered by the SC2470 simulator.
+    // Without a serial option it is derived from the name, so differently named ports are distinct devices.
+    [[nodiscard]] static std::shared_ptr<LoopbackTransport> makeSimulated(const PortSpec& spec, boost::asio::io_context& io);
+
+    LoopbackTransport(std::string name, Responder responder, boost::asio::io_context& io);
+
+    void asyncOpen(Handler handler) override;
+    void close(void) override;
+    void asyncWrite(std::span<const std::string_view> buffers, Handler handler) override;
+    void asyncRead(std::span<char> buffer, Handler handler) override;
+    void cancel(void) override;
+    const std::string& name(void) const override;
+
+private:
+    void complete(Handler handler, const boost::system::error_code& error, std::size_t size);
+    std::size_t take(std::span<char> buffer);
+
+private:
+    std::string m_name;
+    Responder m_responder;
+    boost::asio::io_context& m_io;
+    bool m_open = false;
+    std::string m_line;
+    std::string m_output;
+    std::size_t m_outputBegin = 0;
+    std::span<char> m_readBuffer;
+    Handler m_readHandler; // Read waiting for output
+};
+
+} // namespace fesd
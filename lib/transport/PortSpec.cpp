@@ -0,0 +1,78 @@
+#include "PortSpec.hpp"
+#include <fesd/types/Exception.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <vector>
+
+namespace {
+
+const std::string SchemeSeparator = "://";
+
+} // namespace
+
+namespace fesd {
+
+PortSpec PortSpec::parse(const std::string& port)
+{
+    PortSpec spec;
+    std::string remainder = boost::trim_copy(port);
+
+    const std::size_t query = remainder.find('?');
+    if (query != std::string::npos)
+    {
+        std::vector<std::string> pairs;
+        boost::split(pairs, remainder.substr(query + 1), boost::is_any_of("&"));
+        for (const auto& pair : pairs)
+        {
+            if (pair.empty())
+                continue;
+            const std::size_t equals = pair.find('=');
+            if (equals == std::string::npos)
+                spec.options[pair] = "";
+            else
+                spec.options[pair.substr(0, equals)] = pair.substr(equals + 1);
+        }
+        remainder.erase(query);
+    }
+
+    const std::size_t separator = remainder.find(SchemeSeparator);
+    if (separator != std::string::npos)
+    {
+        spec.scheme = boost::to_lower_copy(remainder.substr(0, separator));
+        remainder.erase(0, separator + SchemeSeparator.size());
+    }
+    spec.address = remainder;
+    return spec;
+}
+
+bool PortSpec::hasOption(const std::string& key) const
+{
+    return options.find(key) != options.end();
+}
+
+std::string PortSpec::option(const std::string& key, const std::string& fallback) const
+{
+    const auto it = options.find(key);
+    return (it == options.end()) ? fallback : it->second;
+}
+
+unsigned long PortSpec::numericOption(const std::string& key, unsigned long fallback, int base) const
+{
+    const auto it = options.find(key);
+    if (it == options.end())
+        return fallback;
+
+    try
+    {
+        std::size_t used = 0;
+        const unsigned long value = std::stoul(it->second, &used, base);
+        if (used == it->second.size())
+            return value;
+    }
+    catch (...)
+    {
+    }
+    throw InvalidArgumentsError("Invalid value for port option " + key + ": " + it->second);
+}
+
+} // namespace fesd
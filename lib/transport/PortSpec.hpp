@@ -0,0 +1,23 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace fesd {
+
+// Port string as given to FESerialDriver, "[scheme://]address[?key=value&key=value]".
+// Plain device names such as "COM3" or "/dev/ttyUSB0" have an empty scheme.
+struct PortSpec
+{
+    std::string scheme;
+    std::string address;
+    std::map<std::string, std::string> options;
+
+    static PortSpec parse(const std::string& port);
+    bool hasOption(const std::string& key) const;
+    std::string option(const std::string& key, const std::string& fallback) const;
+    // Throws InvalidArgumentsError if the option is present but not a number
+    unsigned long numericOption(const std::string& key, unsigned long fallback, int base = 10) const;
+};
+
+} // namespace fesd
@@ -0,0 +1,186 @@
+#include "ReplayTransport.hpp"
+#include "PortSpec.hpp"
+#include "WireLog.hpp"
+#include <fesd/types/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const char Termination = '\r';
+
+} // namespace
+
+namespace fesd {
+
+ReplayTransport::ReplayTransport(const PortSpec& spec, boost::asio::io_context& io)
+    : m_name("replay://" + spec.address), m_io(io), m_timer(io)
+{
+    const std::string timing = spec.option("timing", "original");
+    if (timing != "original" && timing != "compressed")
+        throw InvalidArgumentsError("Invalid value for port option timing: " + timing);
+    m_originalTiming = (timing == "original");
+
+    // Each response is timed from whichever came last in the recording, a command or the previous response
+    std::size_t commands = 0;
+    std::chrono::nanoseconds lastCommand(0);
+    std::chrono::nanoseconds lastResponse(0);
+    for (const WireLog::Record& record : WireLog::read(spec.address))
+    {
+        switch (record.direction)
+        {
+        case WireLog::Direction::Tx:
+            commands += std::count(record.bytes.begin(), record.bytes.end(), Termination);
+            lastCommand = record.time;
+            break;
+        case WireLog::Direction::Open:
+            lastCommand = record.time;
+            break;
+        case WireLog::Direction::Rx:
+        {
+            const bool afterCommand = lastCommand >= lastResponse;
+            m_responses.push_back({commands, afterCommand, record.time - std::max(lastCommand, lastResponse), record.bytes});
+            lastResponse = record.time;
+            break;
+        }
+        }
+    }
+}
+
+void ReplayTransport::asyncOpen(Handler handler)
+{
+    m_open = true;
+    m_writes.emplace_back(m_commands, Clock::now());
+    complete(std::move(handler), {}, 0);
+    release();
+}
+
+void ReplayTransport::close(void)
+{
+    cancel();
+    m_open = false;
+}
+
+void ReplayTransport::asyncWrite(std::span<const std::string_view> buffers, Handler handler)
+{
+    if (!m_open)
+    {
+        complete(std::move(handler), boost::asio::error::bad_descriptor, 0);
+        return;
+    }
+
+    std::size_t size = 0;
+    for (std::string_view buffer : buffers)
+    {
+        size += buffer.size();
+        m_commands += std::count(buffer.begin(), buffer.end(), Termination);
+    }
+    m_writes.emplace_back(m_commands, Clock::now());
+    complete(std::move(handler), {}, size);
+    release();
+}
+
+void ReplayTransport::asyncRead(std::span<char> buffer, Handler handler)
+{
+    if (!m_open)
+    {
+        complete(std::move(handler), boost::asio::error::bad_descriptor, 0);
+        return;
+    }
+    m_readBuffer = buffer;
+    m_readHandler = std::move(handler);
+    serve();
+}
+
+void ReplayTransport::cancel(void)
+{
+    if (m_readHandler)
+        complete(std::exchange(m_readHandler, nullptr), boost::asio::error::operation_aborted, 0);
+}
+
+const std::string& ReplayTransport::name(void) const
+{
+    return m_name;
+}
+
+// Moves the responses that are due to the output, waits on the timer for the next one
+void ReplayTransport::release(void)
+{
+    while (!m_waiting && m_next < m_responses.size())
+    {
+        const Response& response = m_responses[m_next];
+        if (m_commands < response.commandsBefore)
+            break;
+
+        Clock::time_point due = response.afterCommand ? commandTime(response.commandsBefore) : m_lastRelease;
+        if (m_originalTiming)
+            due += std::chrono::duration_cast<Clock::duration>(response.delay);
+
+        if (due > Clock::now())
+        {
+            m_waiting = true;
+            m_timer.expires_at(due);
+            m_timer.async_wait(
+                [weak = weak_from_this()](const boost::system::error_code& error)
+                {
+                    const auto self = weak.lock();
+                    if (!self)
+                        return;
+                    self->m_waiting = false;
+                    if (!error)
+                        self->release();
+                }
+            );
+            break;
+        }
+
+        m_output += response.bytes;
+        m_lastRelease = Clock::now();
+        m_next++;
+    }
+    serve();
+}
+
+void ReplayTransport::serve(void)
+{
+    if (!m_readHandler)
+        return;
+
+    if (m_outputBegin < m_output.size())
+    {
+        const std::size_t count = std::min(m_readBuffer.size(), m_output.size() - m_outputBegin);
+        std::memcpy(m_readBuffer.data(), m_output.data() + m_outputBegin, count);
+        m_outputBegin += count;
+        if (m_outputBegin == m_output.size())
+        {
+            m_output.clear();
+            m_outputBegin = 0;
+        }
+        complete(std::exchange(m_readHandler, nullptr), {}, count);
+    }
+    else if (m_next == m_responses.size())
+        complete(std::exchange(m_readHandler, nullptr), boost::asio::error::eof, 0);
+}
+
+// When the host had sent the given number of commands, earlier writes are no longer needed
+ReplayTransport::Clock::time_point ReplayTransport::commandTime(std::size_t commands)
+{
+    while (m_writes.size() > 1 && m_writes.front().first < commands)
+        m_writes.pop_front();
+    return m_writes.front().second;
+}
+
+// Handlers are never called from inside the initiating function, same as asio
+void ReplayTransport::complete(Handler handler, const boost::system::error_code& error, std::size_t size)
+{
+    boost::asio::post(m_io,
+        [handler = std::move(handler), error, size]()
+        {
+            handler(error, size);
+        }
+    );
+}
+
+} // namespace fesd
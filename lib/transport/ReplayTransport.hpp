@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Transport.hpp"
+
+#include <deque>
+#include <vector>
+
+namespace fesd {
+
+struct PortSpec;
+
+// Plays a wire log back as the device, "replay://path?timing=original|compressed".
+// A recorded response is released once the host has sent as many commands (CRs) as it had when the response came in,
+// so the host may write in different chunks than it did. Original timing keeps the time the device took to answer,
+// compressed releases responses straight away so that only the host side is measured.
+// Reads fail with end of file once the log has been played.
+class ReplayTransport final : public Transport, public std::enable_shared_from_this<ReplayTransport>
+{
+public:
+    ReplayTransport(const PortSpec& spec, boost::asio::io_context& io);
+
+    void asyncOpen(Handler handler) override;
+    void close(void) override;
+    void asyncWrite(std::span<const std::string_view> buffers, Handler handler) override;
+    void asyncRead(std::span<char> buffer, Handler handler) override;
+    void cancel(void) override;
+    const std::string& name(void) const override;
+
+private:
+    struct Response
+    {
+        std::size_t commandsBefore;
+        bool afterCommand; // Timed from the last command rather than from the previous response
+        std::chrono::nanoseconds delay;
+        std::string bytes;
+    };
+
+    void release(void);
+    void serve(void);
+    Clock::time_point commandTime(std::size_t commands);
+    void complete(Handler handler, const boost::system::error_code& error, std::size_t size);
+
+private:
+    std::string m_name;
+    boost::asio::io_context& m_io;
+    boost::asio::steady_timer m_timer;
+    bool m_originalTiming = true;
+    std::vector<Response> m_responses;
+    std::size_t m_next = 0;
+    std::size_t m_commands = 0;
+    std::deque<std::pair<std::size_t, Clock::time_point>> m_writes; // Commands sent so far after each write, and when
+    Clock::time_point m_lastRelease;
+    bool m_waiting = false;
+    bool m_open = false;
+    std::string m_output;
+    std::size_t m_outputBegin = 0;
+    std::span<char> m_readBuffer;
+    Handler m_readHandler;
+};
+
+} // namespace fesd
@@ -0,0 +1,126 @@
+#include "SerialTransport.hpp"
+
+#include <filesystem>
+#include <vector>
+#ifndef WIN32
+#include <termios.h>
+#endif // WIN32
+
+namespace {
+
+using SerialSetting = boost::asio::serial_port_base;
+
+void InitSerialSettings(boost::asio::serial_port& serial)
+{
+    serial.set_option(SerialSetting::baud_rate(115200));
+    serial.set_option(SerialSetting::parity(SerialSetting::parity::even));
+    serial.set_option(SerialSetting::stop_bits(SerialSetting::stop_bits::one));
+    serial.set_option(SerialSetting::flow_control(SerialSetting::flow_control::none));
+}
+
+// Drops what the kernel still holds from before the port was opened, in both directions
+void FlushBuffers(boost::asio::serial_port& serial)
+{
+#ifdef WIN32
+    ::PurgeComm(serial.native_handle(), PURGE_RXCLEAR | PURGE_TXCLEAR);
+#else
+    ::tcflush(serial.native_handle(), TCIOFLUSH);
+#endif // WIN32
+}
+
+// Name that follows a USB serial adapter when it re-enumerates under another tty, the port itself when there is none
+std::string stablePath(const std::string& port)
+{
+#ifndef WIN32
+    std::error_code error;
+    const std::filesystem::path target = std::filesystem::canonical(port, error);
+    if (error)
+        return port;
+
+    for (const auto& link : std::filesystem::directory_iterator("/dev/serial/by-id", error))
+    {
+        std::error_code ignored;
+        if (std::filesystem::canonical(link.path(), ignored) == target)
+            return link.path().string();
+    }
+#endif // WIN32
+    return port;
+}
+
+} // namespace
+
+namespace fesd {
+
+struct SerialTransport::Device
+{
+    std::string port;
+    std::string path; // Opened instead of the port, stays the same across re-enumerations
+    boost::asio::serial_port serial;
+    std::vector<boost::asio::const_buffer> buffers;
+    Device(std::string serialPort, boost::asio::io_context& io) : port(std::move(serialPort)), path(stablePath(port)), serial(io) {}
+};
+
+SerialTransport::SerialTransport(std::string port, boost::asio::io_context& io) : m_dev(std::make_unique<Device>(std::move(port), io))
+{
+}
+SerialTransport::~SerialTransport() = default;
+
+void SerialTransport::asyncOpen(Handler handler)
+{
+    boost::system::error_code error;
+    m_dev->serial.open(m_dev->path, error);
+    if (!error)
+    {
+        try
+        {
+            InitSerialSettings(m_dev->serial);
+            FlushBuffers(m_dev->serial);
+        }
+        catch (const boost::system::system_error& e)
+        {
+            error = e.code();
+            close();
+        }
+    }
+
+    boost::asio::post(m_dev->serial.get_executor(), 
+        [handler = std::move(handler), error]() 
+        { 
+            handler(error, 0); 
+        }
+    );
+}
+
+void SerialTransport::close(void)
+{
+    boost::system::error_code ignored;
+    m_dev->serial.cancel(ignored);
+    m_dev->serial.close(ignored);
+}
+
+void SerialTransport::asyncWrite(std::span<const std::string_view> buffers, Handler handler)
+{
+    m_dev->buffers.clear();
+    for (const auto& buffer : buffers)
+        m_dev->buffers.push_back(boost::asio::buffer(buffer.data(), buffer.size()));
+
+    boost::asio::async_write(m_dev->serial, m_dev->buffers, std::move(handler));
+}
+
+void SerialTransport::asyncRead(std::span<char> buffer, Handler handler)
+{
+    m_dev->serial.async_read_some(boost::asio::buffer(buffer.data(), buffer.size()), std::move(handler));
+}
+
+void SerialTransport::cancel(void)
+{
+    boost::system::error_code ignored;
+    m_dev->serial.cancel(ignored);
+}
+
+const std::string& SerialTransport::name(void) const
+{
+    return m_dev->port;
+}
+
+} // namespace fesd
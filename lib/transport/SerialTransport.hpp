@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Transport.hpp"
+
+namespace fesd {
+
+// Serial port backend, 115200 baud 8E1 without flow control
+class SerialTransport final : public Transport
+{
+public:
+    SerialTransport(std::string port, boost::asio::io_context& io);
+    ~SerialTransport();
+
+    void asyncOpen(Handler handler) override;
+    void close(void) override;
+    void asyncWrite(std::span<const std::string_view> buffers, Handler handler) override;
+    void asyncRead(std::span<char> buffer, Handler handler) override;
+    void cancel(void) override;
+    const std::string& name(void) const override;
+
+private:
+    struct Device;
+    std::unique_ptr<Device> m_dev;
+};
+
+} // namespace fesd
@@ -0,0 +1,422 @@
+#include "TcpTransport.hpp"
+#include "PortSpec.hpp"
+#include <fesd/types/Exception.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <boost/algorithm/string.hpp>
+#include <vector>
+
+namespace {
+
+const uint32_t ConnectTimeoutSeconds = 5;
+const uint32_t DefaultBaudRate = 115200;
+
+// Telnet (RFC 854) and COM port control (RFC 2217) codes
+namespace telnet {
+const unsigned char Se = 240;
+const unsigned char Sb = 250;
+const unsigned char Will = 251;
+const unsigned char Wont = 252;
+const unsigned char Do = 253;
+const unsigned char Dont = 254;
+const unsigned char Iac = 255;
+
+const unsigned char Binary = 0;
+const unsigned char SuppressGoAhead = 3;
+const unsigned char ComPort = 44;
+
+const unsigned char SetBaudRate = 1;
+const unsigned char SetDataSize = 2;
+const unsigned char SetParity = 3;
+const unsigned char SetStopSize = 4;
+const unsigned char SetControl = 5;
+
+const unsigned char ParityNone = 1;
+const unsigned char ParityOdd = 2;
+const unsigned char ParityEven = 3;
+const unsigned char StopSizeOne = 1;
+const unsigned char ControlNoFlowControl = 1;
+} // namespace telnet
+
+enum class TelnetState
+{
+    Data,
+    Iac,
+    Option,
+    Subnegotiation,
+    SubnegotiationIac,
+};
+
+const std::map<std::string, unsigned char> parityMap = {
+    {"none", telnet::ParityNone},
+    {"odd", telnet::ParityOdd},
+    {"even", telnet::ParityEven},
+};
+
+bool acceptLocalOption(unsigned char option)
+{
+    return option == telnet::Binary || option == telnet::SuppressGoAhead || option == telnet::ComPort;
+}
+
+bool acceptRemoteOption(unsigned char option)
+{
+    return option == telnet::Binary || option == telnet::SuppressGoAhead;
+}
+
+// Data bytes equal to IAC are sent twice
+void appendEscaped(std::string& out, std::string_view data)
+{
+    for (char c : data)
+    {
+        out += c;
+        if (static_cast<unsigned char>(c) == telnet::Iac)
+            out += c;
+    }
+}
+
+void appendComPortCommand(std::string& out, unsigned char command, std::string_view value)
+{
+    out += static_cast<char>(telnet::Iac);
+    out += static_cast<char>(telnet::Sb);
+    out += static_cast<char>(telnet::ComPort);
+    out += static_cast<char>(command);
+    appendEscaped(out, value);
+    out += static_cast<char>(telnet::Iac);
+    out += static_cast<char>(telnet::Se);
+}
+
+} // namespace
+
+namespace fesd {
+
+struct TcpTransport::Connection
+{
+    std::string name;
+    std::string host;
+    std::string service;
+    bool rfc2217;
+    uint32_t baudRate;
+    unsigned char parity;
+
+    boost::asio::ip::tcp::resolver resolver;
+    boost::asio::ip::tcp::socket socket;
+    boost::asio::steady_timer timer;
+
+    std::vector<boost::asio::const_buffer> buffers; // Data of the next write
+    std::vector<boost::asio::const_buffer> sending;
+    std::string escaped;
+    Handler writeHandler;
+    bool writing = false;
+    std::string control; // Telnet commands waiting to be sent ahead of the next data
+    std::string controlSending;
+
+    TelnetState state = TelnetState::Data;
+    unsigned char command = 0;
+    std::bitset<256> localOptions;
+    std::bitset<256> remoteOptions;
+
+    Connection(boost::asio::io_context& io) : resolver(io), socket(io), timer(io) {}
+};
+
+TcpTransport::TcpTransport(const PortSpec& spec, boost::asio::io_context& io) : m_conn(std::make_unique<Connection>(io))
+{
+    m_conn->name = spec.scheme + "://" + spec.address;
+    m_conn->rfc2217 = (spec.scheme == "rfc2217") || spec.hasOption("rfc2217");
+    m_conn->baudRate = static_cast<uint32_t>(spec.numericOption("baud", DefaultBaudRate));
+
+    const auto parity = parityMap.find(boost::to_lower_copy(spec.option("parity", "even")));
+    if (parity == parityMap.end())
+        throw InvalidArgumentsError("Invalid parity for port " + m_conn->name);
+    m_conn->parity = parity->second;
+
+    // host:port, IPv6 hosts in brackets
+    const std::size_t separator = spec.address.rfind(':');
+    if (separator == std::string::npos || separator + 1 == spec.address.size())
+        throw InvalidArgumentsError("Missing TCP port number in " + m_conn->name);
+    m_conn->host = spec.address.substr(0, separator);
+    m_conn->service = spec.address.substr(separator + 1);
+    if (m_conn->host.size() >= 2 && m_conn->host.front() == '[' && m_conn->host.back() == ']')
+        m_conn->host = m_conn->host.substr(1, m_conn->host.size() - 2);
+}
+TcpTransport::~TcpTransport() = default;
+
+void TcpTransport::asyncOpen(Handler handler)
+{
+    auto self = shared_from_this();
+
+    m_conn->timer.expires_after(std::chrono::seconds(ConnectTimeoutSeconds));
+    m_conn->timer.async_wait(
+        [self](const boost::system::error_code& error)
+        {
+            // Abort resolving or connecting, the operation completes with an error
+            if (!error)
+            {
+                boost::system::error_code ignored;
+                self->m_conn->resolver.cancel();
+                self->m_conn->socket.close(ignored);
+            }
+        }
+    );
+
+    m_conn->resolver.async_resolve(m_conn->host, m_conn->service, 
+        [self, handler = std::move(handler)](const boost::system::error_code& error, boost::asio::ip::tcp::resolver::results_type endpoints) mutable
+        {
+            if (error)
+            {
+                self->m_conn->timer.cancel();
+                handler(error, 0);
+                return;
+            }
+
+            boost::asio::async_connect(self->m_conn->socket, endpoints, 
+                [self, handler = std::move(handler)](const boost::system::error_code& error, const boost::asio::ip::tcp::endpoint&)
+                {
+                    self->m_conn->timer.cancel();
+                    if (!error)
+                        self->onConnected();
+                    handler(error, 0);
+                }
+            );
+        }
+    );
+}
+
+void TcpTransport::onConnected(void)
+{
+    // Commands are small and latency bound, do not let Nagle hold them back
+    boost::system::error_code ignored;
+    m_conn->socket.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+    m_conn->socket.set_option(boost::asio::socket_base::keep_alive(true), ignored);
+
+    m_conn->state = TelnetState::Data;
+    m_conn->localOptions.reset();
+    m_conn->remoteOptions.reset();
+    m_conn->control.clear();
+    if (m_conn->rfc2217)
+        negotiate();
+}
+
+void TcpTransport::close(void)
+{
+    boost::system::error_code ignored;
+    m_conn->timer.cancel();
+    m_conn->resolver.cancel();
+    m_conn->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+    m_conn->socket.close(ignored);
+}
+
+void TcpTransport::negotiate(void)
+{
+    // Binary mode so CR is not padded, then the same line settings as a local serial port
+    std::string& request = m_conn->control;
+    for (unsigned char option : {telnet::Binary, telnet::SuppressGoAhead, telnet::ComPort})
+    {
+        request += {static_cast<char>(telnet::Iac), static_cast<char>(telnet::Will), static_cast<char>(option)};
+        m_conn->localOptions.set(option);
+    }
+    for (unsigned char option : {telnet::Binary, telnet::SuppressGoAhead})
+    {
+        request += {static_cast<char>(telnet::Iac), static_cast<char>(telnet::Do), static_cast<char>(option)};
+        m_conn->remoteOptions.set(option);
+    }
+
+    const uint32_t baud = m_conn->baudRate;
+    const char baudBytes[] = {static_cast<char>(baud >> 24), static_cast<char>(baud >> 16), static_cast<char>(baud >> 8), static_cast<char>(baud)};
+    appendComPortCommand(request, telnet::SetBaudRate, {baudBytes, sizeof(baudBytes)});
+    appendComPortCommand(request, telnet::SetDataSize, {"\x08", 1});
+    appendComPortCommand(request, telnet::SetParity, {reinterpret_cast<const char*>(&m_conn->parity), 1});
+    appendComPortCommand(request, telnet::SetStopSize, {reinterpret_cast<const char*>(&telnet::StopSizeOne), 1});
+    appendComPortCommand(request, telnet::SetControl, {reinterpret_cast<const char*>(&telnet::ControlNoFlowControl), 1});
+    startWrite();
+}
+
+void TcpTransport::asyncWrite(std::span<const std::string_view> buffers, Handler handler)
+{
+    m_conn->buffers.clear();
+    const bool escape = m_conn->rfc2217 && std::any_of(buffers.begin(), buffers.end(), 
+        [](std::string_view buffer) 
+        { 
+            return buffer.find(static_cast<char>(telnet::Iac)) != std::string_view::npos; 
+        }
+    );
+    if (escape)
+    {
+        m_conn->escaped.clear();
+        for (const auto& buffer : buffers)
+            appendEscaped(m_conn->escaped, buffer);
+        m_conn->buffers.push_back(boost::asio::buffer(m_conn->escaped));
+    }
+    else
+    {
+        for (const auto& buffer : buffers)
+            m_conn->buffers.push_back(boost::asio::buffer(buffer.data(), buffer.size()));
+    }
+
+    // Waits for any Telnet answers already being sent
+    m_conn->writeHandler = std::move(handler);
+    if (!m_conn->writing)
+        startWrite();
+}
+
+void TcpTransport::startWrite(void)
+{
+    m_conn->controlSending.swap(m_conn->control);
+    m_conn->control.clear();
+    m_conn->sending.clear();
+    if (!m_conn->controlSending.empty())
+        m_conn->sending.push_back(boost::asio::buffer(m_conn->controlSending));
+
+    Handler handler = std::exchange(m_conn->writeHandler, nullptr);
+    std::size_t dataSize = 0;
+    if (handler)
+    {
+        for (const auto& buffer : m_conn->buffers)
+        {
+            m_conn->sending.push_back(buffer);
+            dataSize += buffer.size();
+        }
+    }
+    if (m_conn->sending.empty())
+        return;
+
+    m_conn->writing = true;
+    boost::asio::async_write(m_conn->socket, m_conn->sending, 
+        [self = shared_from_this(), handler = std::move(handler), dataSize](const boost::system::error_code& error, std::size_t)
+        {
+            self->m_conn->writing = false;
+            self->m_conn->controlSending.clear();
+            if (handler)
+                handler(error, error ? 0 : dataSize);
+            if (!self->m_conn->writing && (self->m_conn->writeHandler || !self->m_conn->control.empty()))
+                self->startWrite();
+        }
+    );
+}
+
+void TcpTransport::asyncRead(std::span<char> buffer, Handler handler)
+{
+    m_conn->socket.async_read_some(boost::asio::buffer(buffer.data(), buffer.size()), 
+        [self = shared_from_this(), buffer, handler = std::move(handler)](const boost::system::error_code& error, std::size_t size) mutable
+        {
+            if (!self->m_conn->rfc2217)
+            {
+                handler(error, size);
+                return;
+            }
+
+            const std::size_t count = self->filterTelnet(buffer.data(), size);
+            if (!self->m_conn->writing && !self->m_conn->control.empty())
+                self->startWrite();
+
+            // Nothing but Telnet commands, keep reading
+            if (!error && count == 0)
+                self->asyncRead(buffer, std::move(handler));
+            else
+                handler(error, count);
+        }
+    );
+}
+
+void TcpTransport::cancel(void)
+{
+    boost::system::error_code ignored;
+    m_conn->socket.cancel(ignored);
+}
+
+// Removes Telnet commands from received data in place, returns the remaining data size
+std::size_t TcpTransport::filterTelnet(char* data, std::size_t size)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        const unsigned char c = static_cast<unsigned char>(data[i]);
+        switch (m_conn->state)
+        {
+        case TelnetState::Data:
+            if (c == telnet::Iac)
+                m_conn->state = TelnetState::Iac;
+            else
+                data[count++] = data[i];
+            break;
+        case TelnetState::Iac:
+            m_conn->state = TelnetState::Data;
+            if (c == telnet::Iac)
+                data[count++] = data[i];
+            else if (c >= telnet::Will && c <= telnet::Dont)
+            {
+                m_conn->command = c;
+                m_conn->state = TelnetState::Option;
+            }
+            else if (c == telnet::Sb)
+                m_conn->state = TelnetState::Subnegotiation;
+            break;
+        case TelnetState::Option:
+            handleOption(m_conn->command, c);
+            m_conn->state = TelnetState::Data;
+            break;
+        case TelnetState::Subnegotiation:
+            // Setting acknowledgements and line/modem state notifications are not needed
+            if (c == telnet::Iac)
+                m_conn->state = TelnetState::SubnegotiationIac;
+            break;
+        case TelnetState::SubnegotiationIac:
+            m_conn->state = (c == telnet::Se) ? TelnetState::Data : TelnetState::Subnegotiation;
+            break;
+        }
+    }
+    return count;
+}
+
+// Answers option requests, only acknowledging changes so negotiation cannot loop
+void TcpTransport::handleOption(unsigned char command, unsigned char option)
+{
+    auto reply = [this, option](unsigned char answer) 
+    {
+        m_conn->control += {static_cast<char>(telnet::Iac), static_cast<char>(answer), static_cast<char>(option)};
+    };
+
+    switch (command)
+    {
+    case telnet::Do:
+        if (!acceptLocalOption(option))
+            reply(telnet::Wont);
+        else if (!m_conn->localOptions.test(option))
+        {
+            m_conn->localOptions.set(option);
+            reply(telnet::Will);
+        }
+        break;
+    case telnet::Dont:
+        if (m_conn->localOptions.test(option))
+        {
+            m_conn->localOptions.reset(option);
+            reply(telnet::Wont);
+        }
+        break;
+    case telnet::Will:
+        if (!acceptRemoteOption(option))
+            reply(telnet::Dont);
+        else if (!m_conn->remoteOptions.test(option))
+        {
+            m_conn->remoteOptions.set(option);
+            reply(telnet::Do);
+        }
+        break;
+    case telnet::Wont:
+        if (m_conn->remoteOptions.test(option))
+        {
+            m_conn->remoteOptions.reset(option);
+            reply(telnet::Dont);
+        }
+        break;
+    }
+}
+
+const std::string& TcpTransport::name(void) const
+{
+    return m_conn->name;
+}
+
+} // namespace fesd
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Transport.hpp"
+
+namespace fesd {
+
+struct PortSpec;
+
+// Network serial servers (ser2net style).
+// "tcp://host:port" is a raw byte stream, "rfc2217://host:port" or the "rfc2217" option adds Telnet COM port control
+// so the server's serial settings can be negotiated with the "baud" and "parity" (none, odd, even) options.
+class TcpTransport final : public Transport, public std::enable_shared_from_this<TcpTransport>
+{
+public:
+    TcpTransport(const PortSpec& spec, boost::asio::io_context& io);
+    ~TcpTransport();
+
+    void asyncOpen(Handler handler) override;
+    void close(void) override;
+    void asyncWrite(std::span<const std::string_view> buffers, Handler handler) override;
+    void asyncRead(std::span<char> buffer, Handler handler) override;
+    void cancel(void) override;
+    const std::string& name(void) const override;
+
+private:
+    void onConnected(void);
+    void negotiate(void);
+    void startWrite(void);
+    std::size_t filterTelnet(char* data, std::size_t size);
+    void handleOption(unsigned char command, unsigned char option);
+
+private:
+    struct Connection;
+    std::unique_ptr<Connection> m_conn;
+};
+
+} // namespace fesd
@@ -0,0 +1,40 @@
+#include "Transport.hpp"
+#include "CaptureTransport.hpp"
+#include "LoopbackTransport.hpp"
+#include "PortSpec.hpp"
+#include "ReplayTransport.hpp"
+#include "SerialTransport.hpp"
+#include "TcpTransport.hpp"
+#include <fesd/types/Exception.hpp>
+
+namespace {
+
+std::shared_ptr<fesd::Transport> makeBackend(const fesd::PortSpec& spec, const std::string& port, boost::asio::io_context& io)
+{
+    if (spec.scheme.empty() || spec.scheme == "serial")
+        return std::make_shared<fesd::SerialTransport>(spec.address, io);
+    if (spec.scheme == "sim")
+        return fesd::LoopbackTransport::makeSimulated(spec, io);
+    if (spec.scheme == "tcp" || spec.scheme == "rfc2217")
+        return std::make_shared<fesd::TcpTransport>(spec, io);
+    if (spec.scheme == "replay")
+        return std::make_shared<fesd::ReplayTransport>(spec, io);
+
+    throw fesd::InvalidArgumentsError("Unsupported port type " + spec.scheme + " in " + port);
+}
+
+} // namespace
+
+namespace fesd {
+
+[[nodiscard]] std::shared_ptr<Transport> Transport::make(const std::string& port, boost::asio::io_context& io)
+{
+    const PortSpec spec = PortSpec::parse(port);
+
+    std::shared_ptr<Transport> transport = makeBackend(spec, port, io);
+    if (spec.hasOption("capture"))
+        return std::make_shared<CaptureTransport>(std::move(transport), spec.option("capture", ""));
+    return transport;
+}
+
+} // namespace fesd
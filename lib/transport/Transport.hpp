@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#ifdef WIN32
+#include "wintargetsys.h" // required for boost/asio on windows, include before boost/asio
+#endif // WIN32
+#include <boost/asio.hpp>
+
+namespace fesd {
+
+// Byte stream to a chain of devices, driven by the I/O thread that runs its io_context.
+// Framing, pipelining and timeouts are handled by SerialConsole.
+class Transport
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Handler = std::function<void(const boost::system::error_code& error, std::size_t size)>;
+
+    // Picks the backend from the port scheme, plain device names use the serial backend
+    [[nodiscard]] static std::shared_ptr<Transport> make(const std::string& port, boost::asio::io_context& io);
+    virtual ~Transport() = default;
+
+    // Operations are started and completed on the io_context thread, at most one read and one write at a time
+    virtual void asyncOpen(Handler handler) = 0;
+    virtual void close(void) = 0;
+    // Writes all buffers back to back, they must stay valid until the handler is called
+    virtual void asyncWrite(std::span<const std::string_view> buffers, Handler handler) = 0;
+    // Completes as soon as some data is available
+    virtual void asyncRead(std::span<char> buffer, Handler handler) = 0;
+    // Outstanding operations complete with operation_aborted
+    virtual void cancel(void) = 0;
+    virtual const std::string& name(void) const = 0;
+};
+
+} // namespace fesd
@@ -0,0 +1,160 @@
+#include "WireLog.hpp"
+#include <fesd/types/Exception.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+const char Magic[8] = {'F', 'E', 'S', 'D', 'W', 'I', 'R', 'E'};
+const uint32_t Version = 1;
+const std::size_t InitialCapacity = 1 << 20;
+const std::size_t MaxGrowth = 64 << 20;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t startNs;
+};
+
+struct RecordHeader
+{
+    int64_t timeNs;
+    uint32_t size;
+    uint8_t direction;
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(FileHeader) == 24 && sizeof(RecordHeader) == 16);
+
+} // namespace
+
+namespace fesd {
+
+struct WireLog::Writer::Mapping
+{
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    std::size_t capacity = 0;
+};
+
+WireLog::Writer::Writer(const std::string& path)
+    : m_path(path), m_mapping(std::make_unique<Mapping>()), m_start(std::chrono::steady_clock::now())
+{
+    try
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc);
+        m_mapping->file = boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_write);
+    }
+    catch (const std::exception&)
+    {
+        throw InvalidArgumentsError("Cannot create capture file " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    if (!reserve(sizeof(header)))
+        throw InvalidArgumentsError("Cannot create capture file " + path);
+
+    std::memcpy(m_mapping->region.get_address(), &header, sizeof(header));
+    m_size = sizeof(header);
+}
+
+WireLog::Writer::~Writer()
+{
+    m_mapping.reset();
+
+    std::error_code ignored;
+    std::filesystem::resize_file(m_path, m_size, ignored);
+}
+
+void WireLog::Writer::append(Direction direction, std::span<const std::string_view> buffers)
+{
+    std::size_t size = 0;
+    for (std::string_view buffer : buffers)
+        size += buffer.size();
+    if (!m_mapping || !reserve(m_size + sizeof(RecordHeader) + size))
+        return;
+
+    RecordHeader header{};
+    header.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    header.size = static_cast<uint32_t>(size);
+    header.direction = static_cast<uint8_t>(direction);
+
+    char* position = static_cast<char*>(m_mapping->region.get_address()) + m_size;
+    std::memcpy(position, &header, sizeof(header));
+    position += sizeof(header);
+    for (std::string_view buffer : buffers)
+    {
+        std::memcpy(position, buffer.data(), buffer.size());
+        position += buffer.size();
+    }
+    m_size += sizeof(header) + size;
+}
+
+void WireLog::Writer::append(Direction direction, std::string_view bytes)
+{
+    append(direction, std::span<const std::string_view>(&bytes, 1));
+}
+
+// Grows the file and maps it again, doubling up to the maximum growth so small captures stay small
+bool WireLog::Writer::reserve(std::size_t size)
+{
+    if (size <= m_mapping->capacity)
+        return true;
+
+    std::size_t capacity = std::max(m_mapping->capacity, InitialCapacity);
+    while (capacity < size)
+        capacity += std::min(capacity, MaxGrowth);
+
+    try
+    {
+        m_mapping->region = boost::interprocess::mapped_region();
+        std::filesystem::resize_file(m_path, capacity);
+        m_mapping->region = boost::interprocess::mapped_region(m_mapping->file, boost::interprocess::read_write, 0, capacity);
+        m_mapping->capacity = capacity;
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        m_mapping.reset();
+        return false;
+    }
+}
+
+std::vector<WireLog::Record> WireLog::read(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw InvalidArgumentsError("Cannot open wire capture: " + path);
+    const std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+
+    FileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        throw InvalidArgumentsError("Not a wire capture: " + path);
+
+    std::vector<Record> records;
+    RecordHeader recordHeader{};
+    while (file.read(reinterpret_cast<char*>(&recordHeader), sizeof(recordHeader)) && recordHeader.direction != 0)
+    {
+        // The file is grown before a record goes into it, a record never runs past its end
+        if (recordHeader.size > fileSize - file.tellg())
+            throw InvalidArgumentsError("Corrupt wire capture: " + path);
+        Record record{std::chrono::nanoseconds(recordHeader.timeNs), static_cast<Direction>(recordHeader.direction), std::string(recordHeader.size, '\0')};
+        if (!file.read(record.bytes.data(), recordHeader.size))
+            break;
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+} // namespace fesd
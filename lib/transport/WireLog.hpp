@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fesd {
+
+// Binary capture of the bytes that went over a port, in host byte order:
+//   header: "FESDWIRE", uint32 version, uint32 reserved, int64 start of the capture (system clock, ns since the epoch)
+//   record: int64 time since the start (steady clock, ns), uint32 size, uint8 direction, 3 reserved bytes, the bytes
+// A record header of zeroes ends a log that was not closed properly.
+class WireLog final
+{
+public:
+    enum class Direction : uint8_t
+    {
+        Tx = 1,
+        Rx = 2,
+        Open = 3, // The port was (re)opened, no bytes
+    };
+
+    struct Record
+    {
+        std::chrono::nanoseconds time;
+        Direction direction;
+        std::string bytes;
+    };
+
+    // Appends to a memory mapped file that grows in chunks and is trimmed to its contents when the writer goes away.
+    // Recording stops quietly if the file cannot grow, it never fails the port.
+    class Writer final
+    {
+    public:
+        // Throws InvalidArgumentsError if the file cannot be created
+        explicit Writer(const std::string& path);
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void append(Direction direction, std::span<const std::string_view> buffers);
+        void append(Direction direction, std::string_view bytes);
+
+    private:
+        struct Mapping;
+        bool reserve(std::size_t size);
+
+    private:
+        std::string m_path;
+        std::unique_ptr<Mapping> m_mapping;
+        std::size_t m_size = 0;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Throws InvalidArgumentsError if the file is not a wire log
+    static std::vector<Record> read(const std::string& path);
+};
+
+} // namespace fesd
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fesd/fesd.hpp>
+#include "TimingRecorder.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -8,6 +9,7 @@
 namespace fesd {
 
 class DeviceConnection;
+class ShadowState;
 
 struct DeviceDetails
 {
@@ -18,6 +20,8 @@ struct DeviceDetails
     std::string serialNumberStr;
     double firmwareVersion;
     double hardwareVersion;
+    std::shared_ptr<ShadowState> shadow; // Null unless the driver keeps a shadow state of the device
+    std::shared_ptr<SettleStatistics> settle = std::make_shared<SettleStatistics>();
 };
 
 } // namespace fesd
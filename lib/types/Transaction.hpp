@@ -0,0 +1,33 @@
+#pragma once
+
+#include <fesd/types/Exception.hpp>
+
+#include <string>
+#include <vector>
+
+namespace fesd {
+
+struct TransactionResult
+{
+    bool success; // false when the device answered ERR
+    std::string response;
+
+    // Response of a successful command, throws the same error as a single transaction otherwise
+    const std::string& value(void) const
+    {
+        if (!success)
+            throw InvalidArgumentsError("Command Error Returned");
+        return response;
+    }
+};
+
+using TransactionResults = std::vector<TransactionResult>;
+
+// Scheduling class of a transaction on its port, first come first served within a class
+enum class CommandPriority
+{
+    Control,   // Settings and the queries the application acts on
+    Telemetry, // Monitoring polls, they go when no control command waits and after a burst of them at the latest
+};
+
+} // namespace fesd
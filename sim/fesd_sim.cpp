@@ -0,0 +1,291 @@
+// SC2470 device simulator on a pseudo-terminal.
+// Prints the slave device path, which can be passed to FESerialDriver like any other serial port.
+
+#include "sim/SC2470Simulator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Duration = std::chrono::duration<double, std::micro>;
+
+// Start, 8 data, parity and stop bit
+const double BitsPerByte = 11.0;
+const char Etx = 0x03;
+
+volatile std::sig_atomic_t running = 1;
+
+struct Options
+{
+    fesd::sim::SC2470Simulator::Settings settings;
+    uint32_t baudRate = 115200;
+    std::string link;
+    bool verbose = false;
+};
+
+struct PendingLine
+{
+    Clock::time_point arrival; // When the terminating CR has been received over the modelled link
+    std::string text;
+};
+
+struct PendingReply
+{
+    Clock::time_point due; // When the last byte has been sent over the modelled link
+    std::string bytes;
+};
+
+void printUsage(const char* name)
+{
+    std::cerr << "Usage: " << name << " [options]\n"
+              << "  --slots N            Number of SC2470 devices on the port (default 1)\n"
+              << "  --serial HEX         Serial number of slot 0 (default 00C0FFEE)\n"
+              << "  --baud N             Modelled link rate, 0 disables byte timing (default 115200)\n"
+              << "  --delay US           Default per-command processing time in microseconds (default 200)\n"
+              << "  --delay CMD=US       Processing time for one mnemonic, e.g. CONFIG:SAVE=50000\n"
+              << "  --lock-time US       PLL relock time after a retune in microseconds (default 500)\n"
+              << "  --reboot-time MS     Time the device stays silent after *RST (default 3000)\n"
+              << "  --link PATH          Create a symlink to the slave device\n"
+              << "  --verbose            Log every command and reply\n";
+}
+
+bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--verbose")
+        {
+            options.verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+
+        const std::string value = argv[++i];
+        try
+        {
+            if (arg == "--slots")
+                options.settings.slots = static_cast<uint16_t>(std::stoul(value));
+            else if (arg == "--serial")
+                options.settings.serialNumber = static_cast<uint32_t>(std::stoul(value, nullptr, 16));
+            else if (arg == "--baud")
+                options.baudRate = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--lock-time")
+                options.settings.lockTime = std::chrono::microseconds(std::stoll(value));
+            else if (arg == "--reboot-time")
+                options.settings.rebootTime = std::chrono::milliseconds(std::stoll(value));
+            else if (arg == "--link")
+                options.link = value;
+            else if (arg == "--delay")
+            {
+                const std::size_t separator = value.find('=');
+                if (separator == std::string::npos)
+                    options.settings.processingTime = std::chrono::microseconds(std::stoll(value));
+                else
+                    options.settings.commandTimes[value.substr(0, separator)] = std::chrono::microseconds(std::stoll(value.substr(separator + 1)));
+            }
+            else
+                return false;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string printable(const std::string& bytes)
+{
+    std::string result;
+    for (char c : bytes)
+    {
+        if (c == '\r')
+            result += "\\r";
+        else if (c == '\n')
+            result += "\\n";
+        else
+            result += c;
+    }
+    return result;
+}
+
+bool writeAll(int fd, const std::string& bytes)
+{
+    std::size_t written = 0;
+    while (written < bytes.size())
+    {
+        const ssize_t result = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+void stop(int)
+{
+    running = 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || ::grantpt(master) != 0 || ::unlockpt(master) != 0)
+    {
+        std::perror("Failed to create pseudo-terminal");
+        return EXIT_FAILURE;
+    }
+    const std::string slavePath = ::ptsname(master);
+
+    // Hold the slave open so the master does not see a hangup between client connections,
+    // raw mode until the client applies its own serial settings
+    const int slave = ::open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+    termios settings;
+    if (slave < 0 || ::tcgetattr(slave, &settings) != 0)
+    {
+        std::perror("Failed to open pseudo-terminal");
+        return EXIT_FAILURE;
+    }
+    ::cfmakeraw(&settings);
+    ::tcsetattr(slave, TCSANOW, &settings);
+
+    if (!options.link.empty())
+    {
+        ::unlink(options.link.c_str());
+        if (::symlink(slavePath.c_str(), options.link.c_str()) != 0)
+            std::perror("Failed to create link");
+    }
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+
+    fesd::sim::SC2470Simulator simulator(options.settings);
+    const Duration byteTime((options.baudRate == 0) ? 0.0 : (BitsPerByte * 1.0E6 / options.baudRate));
+
+    std::cout << "fesd_sim: " << options.settings.slots << " x SC2470 on " << (options.link.empty() ? slavePath : options.link) << std::endl;
+
+    std::string line;
+    std::deque<PendingLine> lines;
+    std::deque<PendingReply> replies;
+    Clock::time_point rxWireFree = Clock::now();
+    Clock::time_point txWireFree = rxWireFree;
+    Clock::time_point deviceFree = rxWireFree;
+    Clock::time_point rebootUntil = rxWireFree;
+    char buffer[512];
+
+    while (running)
+    {
+        // Sleep until input arrives or the next modelled event is due
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = now + std::chrono::seconds(1);
+        if (!lines.empty())
+            next = std::min(next, std::max(lines.front().arrival, deviceFree));
+        if (!replies.empty())
+            next = std::min(next, replies.front().due);
+
+        // Byte times are well under a millisecond, ppoll keeps them without spinning
+        const auto timeout = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(next - now), std::chrono::nanoseconds::zero());
+        const timespec wait{static_cast<time_t>(timeout.count() / 1000000000), static_cast<long>(timeout.count() % 1000000000)};
+        pollfd descriptor{master, POLLIN, 0};
+        const int ready = ::ppoll(&descriptor, 1, &wait, nullptr);
+
+        now = Clock::now();
+        if (ready > 0 && (descriptor.revents & POLLIN))
+        {
+            const ssize_t count = ::read(master, buffer, sizeof(buffer));
+            if (count < 0 && errno != EINTR && errno != EAGAIN)
+                break;
+
+            // Bytes are received one after the other over the modelled link
+            Clock::time_point arrival = std::max(now, rxWireFree);
+            for (ssize_t i = 0; i < count; i++)
+            {
+                arrival += std::chrono::duration_cast<Clock::duration>(byteTime);
+                if (buffer[i] == Etx)
+                {
+                    // ETX clears anything the device has not started on yet
+                    line.clear();
+                    lines.clear();
+                }
+                else if (buffer[i] == '\r')
+                {
+                    if (arrival >= rebootUntil)
+                        lines.push_back({arrival, line});
+                    line.clear();
+                }
+                else if (buffer[i] != '\n')
+                    line += buffer[i];
+            }
+            rxWireFree = arrival;
+        }
+
+        // Commands are processed one at a time in arrival order
+        while (!lines.empty() && std::max(lines.front().arrival, deviceFree) <= now)
+        {
+            const PendingLine pending = lines.front();
+            lines.pop_front();
+
+            const fesd::sim::SC2470Simulator::Reply reply = simulator.process(pending.text);
+            deviceFree = now + reply.processingTime;
+            if (options.verbose)
+                std::cout << "<< " << pending.text << "\n>> " << printable(reply.bytes) << std::endl;
+
+            if (reply.rebootTime.count() > 0)
+            {
+                rebootUntil = deviceFree + reply.rebootTime;
+                deviceFree = rebootUntil;
+                lines.clear();
+                replies.clear();
+            }
+
+            if (!reply.bytes.empty())
+            {
+                txWireFree = std::max(deviceFree, txWireFree) + std::chrono::duration_cast<Clock::duration>(byteTime * static_cast<double>(reply.bytes.size()));
+                replies.push_back({txWireFree, reply.bytes});
+            }
+        }
+
+        while (!replies.empty() && replies.front().due <= now)
+        {
+            if (!writeAll(master, replies.front().bytes))
+                running = 0;
+            replies.pop_front();
+        }
+    }
+
+    if (!options.link.empty())
+        ::unlink(options.link.c_str());
+    ::close(slave);
+    ::close(master);
+    return EXIT_SUCCESS;
+}